@@ -3,38 +3,151 @@
 #include <WiFiClientSecure.h>
 #include <HTTPClient.h>
 #include <BatteryMonitor.h>
+#include <SDCardManager.h>
 
 #include <algorithm>
+#include <stdlib.h>
+#include <string.h>
+
+#include "ApiRequest.h"
+#include "ApiResponseParser.h"
+#include "BulkReader.h"
+#include "CachedDnsClient.h"
+#include "EnergyMeter.h"
+#include "HeapMonitor.h"
+#include "ImageRenderer.h"
+#include "LogUploader.h"
+#include "RefreshPlanner.h"
+#include "SdBus.h"
+#include "ServerHealth.h"
+#include "Telemetry.h"
+#include "WakeBudget.h"
+#include "WallClock.h"
 
 // Global battery monitor instance - initialized in main task (not yet implemented)
 // For now, return default values if not initialized
 static BatteryMonitor* g_batteryMonitor = nullptr;
 
-void ApiClient::setBatteryMonitor(BatteryMonitor* battery) {
-    g_batteryMonitor = battery;
+// Fixed buffers for the whole fetch path. They live in .bss rather than on
+// the heap, so nothing here competes with the TLS handshake for a
+// contiguous block.
+static char urlBuffer[MAX_URL_LENGTH];
+static char responseBuffer[ApiClient::RESPONSE_BUFFER_SIZE];
+static uint8_t imageBuffer[ApiClient::MAX_IMAGE_SIZE];
+
+// Image bytes received so far (in imageBuffer). Kept across downloadImage()
+// calls so an interrupted transfer can resume with a Range request instead
+// of restarting.
+struct PartialImage {
+    char url[MAX_URL_LENGTH];
+    char validator[96];  ///< Strong ETag or Last-Modified, sent as If-Range; empty = length check only
+    size_t total;
+    size_t received;
+};
+static PartialImage partialImage;
+
+// A partial image left when the wake budget ran out waits on SD for the next
+// wake: the header below, then the received bytes. The RTC flag saves a card
+// access on every other wake.
+static constexpr const char* PARTIAL_IMAGE_DIR = "/.trmnl";
+static constexpr const char* PARTIAL_IMAGE_PATH = "/.trmnl/partial.img";
+static constexpr uint32_t PARTIAL_IMAGE_MAGIC = 0x54524150;  // "PART"
+RTC_DATA_ATTR static bool rtcPartialImageSaved = false;
+
+struct PartialImageFile {
+    uint32_t magic;
+    PartialImage image;
+};
+
+static void resetPartialImage(const char* url) {
+    strlcpy(partialImage.url, url, sizeof(partialImage.url));
+    partialImage.validator[0] = '\0';
+    partialImage.total = 0;
+    partialImage.received = 0;
 }
 
-String ApiClient::buildApiUrl(const String& serverUrl) {
-    String url = serverUrl;
-    if (url.endsWith("/")) {
-        url = url.substring(0, url.length() - 1);
+// Moves a partial image saved before the last deep sleep back into
+// imageBuffer, if it is for imageUrl. The file is removed either way; a
+// download that runs out of budget again saves a fresh one.
+static bool restorePartialImage(const char* imageUrl) {
+    if (!rtcPartialImageSaved) {
+        return false;
+    }
+    rtcPartialImageSaved = false;
+
+    SdBus::Scope sd;
+    if (!sd.mounted()) {
+        return false;
+    }
+    PartialImageFile header;
+    bool restored = false;
+    FsFile file = SdMan.open(PARTIAL_IMAGE_PATH, O_RDONLY);
+    if (file) {
+        restored = file.read(reinterpret_cast<uint8_t*>(&header), sizeof(header)) == static_cast<int>(sizeof(header)) &&
+                   header.magic == PARTIAL_IMAGE_MAGIC && strcmp(header.image.url, imageUrl) == 0 &&
+                   header.image.total <= ApiClient::MAX_IMAGE_SIZE && header.image.received < header.image.total &&
+                   file.read(imageBuffer, header.image.received) == static_cast<int>(header.image.received);
+        file.close();
     }
-    return url + "/api/display";
+    SdMan.remove(PARTIAL_IMAGE_PATH);
+    if (restored) {
+        partialImage = header.image;
+        partialImage.url[sizeof(partialImage.url) - 1] = '\0';
+        partialImage.validator[sizeof(partialImage.validator) - 1] = '\0';
+    }
+    return restored;
 }
 
-String ApiClient::getBatteryVoltage() {
-    if (g_batteryMonitor != nullptr) {
-        double volts = g_batteryMonitor->readVolts();
-        return String(volts, 2);
+// If-Range only accepts strong validators, so weak ETags fall back to Last-Modified.
+static void storeValidator(const String& etag, const String& lastModified) {
+    const String& validator = (!etag.isEmpty() && !etag.startsWith("W/")) ? etag : lastModified;
+    if (validator.length() >= sizeof(partialImage.validator)) {
+        partialImage.validator[0] = '\0';
+        return;
     }
-    return "0.0";
+    strlcpy(partialImage.validator, validator.c_str(), sizeof(partialImage.validator));
 }
 
-String ApiClient::getWifiRssi() {
-    if (WiFi.status() == WL_CONNECTED) {
-        return String(WiFi.RSSI());
+// Sink for HTTPClient::writeToStream(), which also decodes chunked bodies.
+// Refuses writes past the capacity instead of growing.
+class FixedBufferStream : public Stream {
+public:
+    FixedBufferStream(char* buffer, size_t capacity) : buffer_(buffer), capacity_(capacity), length_(0) {
+        buffer_[0] = '\0';
     }
-    return "0";
+
+    size_t write(uint8_t c) override { return write(&c, 1); }
+    size_t write(const uint8_t* data, size_t size) override {
+        if (size >= capacity_ - length_) {
+            return 0;
+        }
+        memcpy(buffer_ + length_, data, size);
+        length_ += size;
+        buffer_[length_] = '\0';
+        return size;
+    }
+    int available() override { return 0; }
+    int read() override { return -1; }
+    int peek() override { return -1; }
+
+    size_t length() const { return length_; }
+
+private:
+    char* buffer_;
+    size_t capacity_;
+    size_t length_;
+};
+
+void ApiClient::setBatteryMonitor(BatteryMonitor* battery) {
+    g_batteryMonitor = battery;
+}
+
+double ApiClient::batteryVolts() {
+    return (g_batteryMonitor != nullptr) ? g_batteryMonitor->readVolts() : 0.0;
+}
+
+int ApiClient::wifiRssi() {
+    return (WiFi.status() == WL_CONNECTED) ? static_cast<int>(WiFi.RSSI()) : 0;
 }
 
 DisplayFetchResult ApiClient::fetchDisplay(const TrmnlConfig& config) {
@@ -46,41 +159,108 @@ DisplayFetchResult ApiClient::fetchDisplay(const TrmnlConfig& config) {
         return result;
     }
 
-    String url = buildApiUrl(config.serverUrl);
-    WiFiClientSecure client;
+    CachedDnsClient client(config.dnsCacheTtlSeconds);
 
     if (config.useInsecureTls) {
         client.setInsecure();
     }
 
     HTTPClient http;
-    http.setTimeout(API_TIMEOUT_MS);
+    // Keep the socket open after /api/display so queued logs can ride on it.
+    http.setReuse(true);
+
+    // Report the cadence we actually slept with last time, not just the configured one.
+    const uint32_t plannedRate = RefreshPlanner::lastPlannedSeconds();
+    char energySummary[96];
+    EnergyMeter::formatSummary(config.energyModel, energySummary, sizeof(energySummary));
+    ApiRequest::DeviceState device;
+    device.refreshRate = plannedRate != 0 ? plannedRate : config.refreshInterval;
+    device.batteryVolts = batteryVolts();
+    device.rssi = wifiRssi();
+    device.energySummary = energySummary;
+    const ApiRequest::DisplayHeaders headers(config, device);
+    const char* collectKeys[] = {"Date"};
+
+    uint8_t order[TrmnlConfig::MAX_SERVER_URLS];
+    const size_t serverCount = ServerHealth::rank(config, order);
+
+    EnergyMeter::Scope transfer(EnergyMeter::State::TRANSFER);
+    size_t serverIndex = 0;
+    int httpCode = HTTPC_ERROR_CONNECTION_REFUSED;
+    uint32_t requestStart = 0;
+
+    // Try servers best first. Only the last one gets the full read timeout,
+    // so a partial outage costs at most a few short timeouts per wake.
+    for (size_t attempt = 0; attempt < serverCount; ++attempt) {
+        const size_t index = order[attempt];
+        const bool lastServer = attempt + 1 == serverCount;
+        serverIndex = index;
+
+        if (WakeBudget::expired()) {
+            result.result = ApiResult(ApiError::TIMEOUT, "Wake budget exhausted before the API request");
+            return result;
+        }
+        http.setConnectTimeout(static_cast<int32_t>(WakeBudget::clamp(SERVER_CONNECT_TIMEOUT_MS)));
+        http.setTimeout(WakeBudget::clamp(lastServer ? API_TIMEOUT_MS : FAILOVER_TIMEOUT_MS));
+        if (!ApiRequest::buildUrl(urlBuffer, sizeof(urlBuffer), config.serverUrls[index], "/api/display") ||
+            !http.begin(client, urlBuffer)) {
+            ServerHealth::recordFailure(index);
+            if (lastServer) {
+                result.result = ApiResult(ApiError::INVALID_URL,
+                                           "Failed to begin HTTP request");
+                return result;
+            }
+            continue;
+        }
 
-    if (!http.begin(client, url)) {
-        result.result = ApiResult(ApiError::INVALID_URL,
-                                   "Failed to begin HTTP request");
-        return result;
-    }
+        for (const ApiHeader& header : headers) {
+            http.addHeader(header.name, header.value);
+        }
+        http.collectHeaders(collectKeys, sizeof(collectKeys) / sizeof(collectKeys[0]));
 
-    http.addHeader("ID", config.deviceId);
-    http.addHeader("Access-Token", config.apiKey);
-    http.addHeader("Refresh-Rate", String(config.refreshInterval));
-    http.addHeader("Battery-Voltage", getBatteryVoltage());
-    http.addHeader("FW-Version", FW_VERSION);
-    http.addHeader("RSSI", getWifiRssi());
+        requestStart = millis();
+        httpCode = http.GET();
+        const uint32_t ttfbMs = millis() - requestStart;
 
-    int httpCode = http.GET();
+        if (httpCode > 0 && httpCode < 500) {
+            ServerHealth::recordSuccess(index, ttfbMs);
+            break;
+        }
+
+        ServerHealth::recordFailure(index);
+        if (lastServer) {
+            break;
+        }
+        Telemetry::record(Telemetry::Event::SERVER_FAILOVER, static_cast<int32_t>(index), httpCode,
+                          static_cast<int32_t>(ttfbMs));
+        Serial.printf("Server %s failed (%d), trying next\n", config.serverUrls[index].c_str(), httpCode);
+        http.end();
+        client.stop();
+    }
     result.result.httpStatus = httpCode;
 
-    if (httpCode == HTTP_CODE_OK) {
-        String responseBody = http.getString();
+    if (httpCode > 0) {
+        WallClock::setFromHttpDate(http.header("Date").c_str());
+    }
 
-        ApiResult parseResult = parseApiResponse(responseBody,
-                                                   result.imageUrl,
-                                                   result.refreshRate,
-                                                   result.trmnlStatus);
+    if (httpCode == HTTP_CODE_OK) {
+        FixedBufferStream body(responseBuffer, sizeof(responseBuffer));
+        const int written = http.writeToStream(&body);
+        Telemetry::record(Telemetry::Event::API_RESPONSE, httpCode, static_cast<int32_t>(millis() - requestStart),
+                          static_cast<int32_t>(body.length()));
+
+        ApiResult parseResult = written < 0
+                                    ? ApiResult(ApiError::JSON_PARSE_FAILED, "Response too large or truncated", httpCode)
+                                    : ApiResponseParser::parse(responseBuffer,
+                                                       body.length(),
+                                                       result.imageUrl,
+                                                       result.refreshRate,
+                                                       result.trmnlStatus,
+                                                       result.firmware);
+        HeapMonitor::mark(HeapMonitor::Stage::API_RESPONSE);
 
         if (parseResult.error != ApiError::SUCCESS) {
+            Telemetry::record(Telemetry::Event::API_ERROR, static_cast<int32_t>(parseResult.error), httpCode);
             result.result = parseResult;
             http.end();
             return result;
@@ -88,6 +268,17 @@ DisplayFetchResult ApiClient::fetchDisplay(const TrmnlConfig& config) {
 
         http.end();
 
+        // Logs wait for a later wake rather than eat into the image download's budget.
+        http.setTimeout(WakeBudget::clamp(API_TIMEOUT_MS));
+        const size_t logsSent =
+            !WakeBudget::expired() &&
+                    ApiRequest::buildUrl(urlBuffer, sizeof(urlBuffer), config.serverUrls[serverIndex], "/api/log")
+                ? LogUploader::upload(http, client, urlBuffer, config)
+                : 0;
+        if (logsSent > 0) {
+            Serial.printf("Uploaded %u log entries\n", static_cast<unsigned>(logsSent));
+        }
+
         if (result.trmnlStatus == TrmnlStatus::NO_UPDATE) {
             result.result = ApiResult(ApiError::SUCCESS,
                                        "No update available",
@@ -95,12 +286,16 @@ DisplayFetchResult ApiClient::fetchDisplay(const TrmnlConfig& config) {
             return result;
         }
 
-        if (!result.imageUrl.isEmpty()) {
+        if (result.imageUrl[0] != '\0') {
             ApiResult downloadResult = downloadImage(result.imageUrl,
                                                      result.imageData,
+                                                     result.imageSize,
                                                      config);
+            HeapMonitor::mark(HeapMonitor::Stage::IMAGE_DOWNLOAD);
 
             if (downloadResult.error != ApiError::SUCCESS) {
+                Telemetry::record(Telemetry::Event::API_ERROR, static_cast<int32_t>(downloadResult.error),
+                                  downloadResult.httpStatus);
                 result.result = downloadResult;
                 return result;
             }
@@ -151,81 +346,130 @@ DisplayFetchResult ApiClient::fetchDisplay(const TrmnlConfig& config) {
                                    httpCode);
     }
 
+    if (result.result.error != ApiError::SUCCESS) {
+        Telemetry::record(Telemetry::Event::API_ERROR, static_cast<int32_t>(result.result.error), httpCode);
+    }
     http.end();
     return result;
 }
 
-ApiResult ApiClient::parseApiResponse(const String& responseBody,
-                                        String& imageUrl,
-                                        uint32_t& refreshRate,
-                                        TrmnlStatus& trmnlStatus) {
-    JsonDocument doc;
-    DeserializationError error = deserializeJson(doc, responseBody);
-
-    if (error) {
-        char errorMsg[128];
-        snprintf(errorMsg, sizeof(errorMsg), "JSON parse error: %s", error.c_str());
-        return ApiResult(ApiError::JSON_PARSE_FAILED, errorMsg);
+ApiResult ApiClient::downloadImage(const char* imageUrl,
+                                    const uint8_t*& imageData,
+                                    size_t& imageSize,
+                                    const TrmnlConfig& config) {
+    if (strcmp(partialImage.url, imageUrl) != 0) {
+        resetPartialImage(imageUrl);
+        if (restorePartialImage(imageUrl)) {
+            Serial.printf("Resuming image saved last wake at %u/%u bytes\n",
+                          static_cast<unsigned>(partialImage.received), static_cast<unsigned>(partialImage.total));
+        }
     }
 
-    if (!doc["status"].is<int>()) {
-        return ApiResult(ApiError::MISSING_REQUIRED_FIELD,
-                          "Missing required field: status");
+    // Modem sleep delays every received frame until the next DTIM wake;
+    // for a burst transfer the radio finishes sooner with it off.
+    if (!config.downloadPowerSave) {
+        WiFi.setSleep(false);
     }
-
-    {
-        const int status = doc["status"].as<int>();
-        trmnlStatus = static_cast<TrmnlStatus>(status);
-        if (status == static_cast<int>(TrmnlStatus::NO_UPDATE)) {
-            return ApiResult(ApiError::SUCCESS, "");
+    ApiResult result(ApiError::TIMEOUT, "Wake budget exhausted before the image download");
+    for (uint8_t attempt = 0; attempt < MAX_DOWNLOAD_ATTEMPTS && !WakeBudget::expired(); ++attempt) {
+        result = downloadImageAttempt(imageUrl, config);
+        if (result.error == ApiError::SUCCESS) {
+            break;
         }
-        if (status != static_cast<int>(TrmnlStatus::SUCCESS)) {
-            char msg[96];
-            snprintf(msg, sizeof(msg), "TRMNL status error: %d", status);
-            return ApiResult(ApiError::HTTP_REQUEST_FAILED, msg);
+        // Only an interrupted transfer with something to keep is worth another try.
+        if (result.error != ApiError::IMAGE_DOWNLOAD_FAILED || result.httpStatus >= 400 ||
+            partialImage.received == 0) {
+            break;
         }
+        Serial.printf("Image download interrupted at %u/%u bytes, resuming\n",
+                      static_cast<unsigned>(partialImage.received), static_cast<unsigned>(partialImage.total));
+    }
+    if (!config.downloadPowerSave) {
+        WiFi.setSleep(true);
     }
 
-    if (doc["image_url"].is<const char*>()) {
-        imageUrl = doc["image_url"].as<String>();
-    } else {
-        return ApiResult(ApiError::MISSING_REQUIRED_FIELD,
-                          "Missing required field: image_url");
+    if (result.error == ApiError::SUCCESS) {
+        imageData = imageBuffer;
+        imageSize = partialImage.total;
+        resetPartialImage("");
     }
+    return result;
+}
 
-    if (doc["refresh_rate"].is<const char*>()) {
-        const char* rr = doc["refresh_rate"].as<const char*>();
-        refreshRate = String(rr ? rr : "").toInt();
-    } else if (doc["refresh_rate"].is<int>()) {
-        refreshRate = static_cast<uint32_t>(doc["refresh_rate"].as<int>());
+bool ApiClient::savePartialImage() {
+    if (partialImage.received == 0 || partialImage.received >= partialImage.total) {
+        return false;
     }
-    if (refreshRate == 0) {
-        refreshRate = 1800;
+    SdBus::Scope sd;
+    if (!sd.mounted()) {
+        return false;
     }
-
-    return ApiResult(ApiError::SUCCESS, "");
+    if (!SdMan.exists(PARTIAL_IMAGE_DIR)) {
+        SdMan.mkdir(PARTIAL_IMAGE_DIR);
+    }
+    FsFile file = SdMan.open(PARTIAL_IMAGE_PATH, O_WRONLY | O_CREAT | O_TRUNC);
+    if (!file) {
+        return false;
+    }
+    PartialImageFile header;
+    header.magic = PARTIAL_IMAGE_MAGIC;
+    header.image = partialImage;
+    size_t written = file.write(reinterpret_cast<const uint8_t*>(&header), sizeof(header));
+    written += file.write(imageBuffer, partialImage.received);
+    file.close();
+    rtcPartialImageSaved = written == sizeof(header) + partialImage.received;
+    return rtcPartialImageSaved;
 }
 
-ApiResult ApiClient::downloadImage(const String& imageUrl,
-                                    std::vector<uint8_t>& imageData,
-                                    const TrmnlConfig& config) {
-    WiFiClientSecure client;
+ApiResult ApiClient::downloadImageAttempt(const char* imageUrl, const TrmnlConfig& config) {
+    CachedDnsClient client(config.dnsCacheTtlSeconds);
 
     if (config.useInsecureTls) {
         client.setInsecure();
     }
 
     HTTPClient http;
-    http.setTimeout(IMAGE_TIMEOUT_MS);
+    http.setConnectTimeout(static_cast<int32_t>(WakeBudget::clamp(SERVER_CONNECT_TIMEOUT_MS)));
+    http.setTimeout(WakeBudget::clamp(IMAGE_TIMEOUT_MS));
 
     if (!http.begin(client, imageUrl)) {
         return ApiResult(ApiError::INVALID_URL,
                           "Failed to begin image download");
     }
 
+    // Offer the raw framebuffer format; servers that don't know it send the BMP.
+    char accept[64];
+    ApiRequest::formatImageAccept(accept, sizeof(accept));
+    http.addHeader("Accept", accept);
+
+    const size_t offset = partialImage.received;
+    if (offset > 0) {
+        char range[32];
+        snprintf(range, sizeof(range), "bytes=%u-", static_cast<unsigned>(offset));
+        http.addHeader("Range", range);
+        if (partialImage.validator[0] != '\0') {
+            http.addHeader("If-Range", partialImage.validator);
+        }
+    }
+    const char* collectKeys[] = {"ETag", "Last-Modified", "Content-Range"};
+    http.collectHeaders(collectKeys, sizeof(collectKeys) / sizeof(collectKeys[0]));
+
+    const uint32_t downloadStart = millis();
     int httpCode = http.GET();
 
-    if (httpCode == HTTP_CODE_OK) {
+    if (httpCode == HTTP_CODE_PARTIAL_CONTENT && offset > 0) {
+        unsigned long first = 0;
+        unsigned long last = 0;
+        unsigned long total = 0;
+        if (sscanf(http.header("Content-Range").c_str(), "bytes %lu-%lu/%lu", &first, &last, &total) != 3 ||
+            first != offset || total != partialImage.total) {
+            http.end();
+            resetPartialImage(imageUrl);
+            return ApiResult(ApiError::IMAGE_DOWNLOAD_FAILED,
+                              "Unexpected Content-Range on resume", httpCode);
+        }
+    } else if (httpCode == HTTP_CODE_OK) {
+        // First attempt, or the image changed and If-Range sent the whole thing.
         int contentLength = http.getSize();
 
         if (contentLength <= 0) {
@@ -240,42 +484,52 @@ ApiResult ApiClient::downloadImage(const String& imageUrl,
                               "Image exceeds maximum size");
         }
 
-        imageData.resize(contentLength);
-        WiFiClient* stream = http.getStreamPtr();
-        
-        size_t bytesRead = 0;
-        unsigned long startTime = millis();
-        while (http.connected() && (bytesRead < (size_t)contentLength) && (millis() - startTime < IMAGE_TIMEOUT_MS)) {
-            const size_t available = static_cast<size_t>(stream->available());
-            if (available > 0) {
-                const size_t remaining = static_cast<size_t>(contentLength) - bytesRead;
-                const size_t toRead = std::min(available, remaining);
-                const int r = stream->read(imageData.data() + bytesRead, toRead);
-                if (r > 0) {
-                    bytesRead += static_cast<size_t>(r);
-                    startTime = millis();
-                }
-            }
-            delay(1);
-        }
-
-        http.end();
-
-        if (bytesRead != (size_t)contentLength) {
-            imageData.clear();
-            return ApiResult(ApiError::IMAGE_DOWNLOAD_FAILED,
-                              "Failed to read complete image data");
-        }
-
-        return ApiResult(ApiError::SUCCESS,
-                          "Image downloaded successfully",
-                          httpCode);
-
+        resetPartialImage(imageUrl);
+        partialImage.total = static_cast<size_t>(contentLength);
+        storeValidator(http.header("ETag"), http.header("Last-Modified"));
     } else {
         http.end();
+        if (httpCode == HTTP_CODE_RANGE_NOT_SATISFIABLE) {
+            resetPartialImage(imageUrl);
+        }
         char errorMsg[128];
         snprintf(errorMsg, sizeof(errorMsg),
                  "Image download failed with HTTP code: %d", httpCode);
         return ApiResult(ApiError::IMAGE_DOWNLOAD_FAILED, errorMsg, httpCode);
     }
+
+    BulkReader reader(client, IMAGE_INACTIVITY_MS);
+    if (config.downloadRcvBuf > 0 && !reader.setReceiveBuffer(config.downloadRcvBuf)) {
+        Serial.println("download_rcvbuf not supported by this lwIP build");
+    }
+    const size_t startBytes = partialImage.received;
+    while (partialImage.received < partialImage.total) {
+        const size_t r = reader.read(imageBuffer + partialImage.received, partialImage.total - partialImage.received);
+        if (r == 0) {
+            break;
+        }
+        partialImage.received += r;
+    }
+
+    http.end();
+    const BulkReader::Stats& stats = reader.stats();
+    Serial.printf("Image: %u bytes in %u ms (%u B/s, %u reads, %u waits)\n", static_cast<unsigned>(stats.bytes),
+                  static_cast<unsigned>(stats.ms), static_cast<unsigned>(stats.bytesPerSecond()),
+                  static_cast<unsigned>(stats.reads), static_cast<unsigned>(stats.waits));
+    Telemetry::record(Telemetry::Event::IMAGE_DOWNLOAD, httpCode, static_cast<int32_t>(millis() - downloadStart),
+                      static_cast<int32_t>(partialImage.received - startBytes));
+    Telemetry::record(Telemetry::Event::DOWNLOAD_STATS, static_cast<int32_t>(stats.bytesPerSecond()),
+                      static_cast<int32_t>(stats.reads), static_cast<int32_t>(stats.waits));
+
+    if (partialImage.received != partialImage.total) {
+        if (WakeBudget::expired()) {
+            return ApiResult(ApiError::TIMEOUT, "Wake budget exhausted during the image download", httpCode);
+        }
+        return ApiResult(ApiError::IMAGE_DOWNLOAD_FAILED,
+                          "Failed to read complete image data", httpCode);
+    }
+
+    return ApiResult(ApiError::SUCCESS,
+                      "Image downloaded successfully",
+                      httpCode);
 }
@@ -2,9 +2,9 @@
 
 #include <Arduino.h>
 #include <ArduinoJson.h>
-#include <vector>
 
 #include "ConfigLoader.h"
+#include "PanelGeometry.h"
 
 class BatteryMonitor;
 
@@ -50,17 +50,33 @@ struct ApiResult {
     ApiResult(ApiError err, const char* msg, int httpStat) : error(err), errorMessage(msg), httpStatus(httpStat) {}
 };
 
+static constexpr size_t MAX_URL_LENGTH = 256;  ///< Including terminator
+
+/**
+ * @brief Firmware update offered by the server in the /api/display response
+ */
+struct FirmwareUpdate {
+    bool available;            ///< "update_firmware": true
+    char url[MAX_URL_LENGTH];  ///< "firmware_url"
+    char sha256[65];           ///< "firmware_sha256" (hex), required before flashing
+
+    FirmwareUpdate() : available(false), url(), sha256() {}
+};
+
 /**
  * @brief Result structure for display fetch operations
  */
 struct DisplayFetchResult {
     ApiResult result;                ///< API operation result
-    std::vector<uint8_t> imageData;  ///< Image data buffer
-    String imageUrl;                  ///< Image URL from server
+    const uint8_t* imageData;        ///< Image bytes in ApiClient's static buffer; valid until the next fetch
+    size_t imageSize;                ///< Number of valid bytes at imageData
+    char imageUrl[MAX_URL_LENGTH];   ///< Image URL from server
     uint32_t refreshRate;            ///< Refresh rate in seconds from server
     TrmnlStatus trmnlStatus;         ///< TRMNL status from JSON response
+    FirmwareUpdate firmware;         ///< Pending firmware update, if any
 
-    DisplayFetchResult() : refreshRate(1800), trmnlStatus(TrmnlStatus::SUCCESS) {}
+    DisplayFetchResult()
+        : imageData(nullptr), imageSize(0), imageUrl(), refreshRate(1800), trmnlStatus(TrmnlStatus::SUCCESS) {}
 };
 
 /**
@@ -70,8 +86,13 @@ struct DisplayFetchResult {
  * - Fetch display configuration and image URL from /api/display
  * - Download image from returned URL
  * - Handle all TRMNL-specific headers and response formats
+ * - Upload queued device logs to /api/log on the display request's connection
  *
  * Uses WiFiClientSecure for HTTPS connections with optional insecure TLS mode.
+ *
+ * The fetch path does not allocate its large buffers: the response body,
+ * the parsed JSON document (ApiResponseParser) and the image all live in
+ * fixed static buffers, so the heap stays unfragmented for TLS.
  */
 class ApiClient {
 public:
@@ -87,76 +108,95 @@ public:
     /**
      * @brief Fetch display information and image from TRMNL server
      *
-     * Makes GET request to {config.serverUrl}/api/display with required headers:
+     * Makes GET request to {serverUrl}/api/display with the headers built
+     * by ApiRequest::DisplayHeaders:
      * - ID: {deviceId}
      * - Access-Token: {apiKey}
-     * - Refresh-Rate: {refreshInterval}
+     * - Refresh-Rate: {interval planned on the previous wake, else refreshInterval}
      * - Battery-Voltage: {voltage}
      * - FW-Version: 0.1.0
      * - RSSI: {wifiRssi}
+     * - Energy-Summary: {EnergyMeter::formatSummary()}
      *
      * Response JSON format:
      * {
      *   "status": 0,              // 0 = success, 202 = no update
      *   "image_url": "https://...",
-     *   "refresh_rate": "1800"     // May be string or int
+     *   "refresh_rate": "1800",    // May be string or int
+     *   "update_firmware": false,  // Optional, with firmware_url / firmware_sha256
      * }
      *
-     * @param config TrmnlConfig with server URL, API key, device ID, etc.
+     * Servers in config.serverUrls are tried in the order chosen by
+     * ServerHealth, moving on after a connect failure, timeout or 5xx.
+     *
+     * @param config TrmnlConfig with server URLs, API key, device ID, etc.
      * @return DisplayFetchResult Contains image data, metadata, and status
      */
     static DisplayFetchResult fetchDisplay(const TrmnlConfig& config);
 
-private:
-    /**
-     * @brief Build full API URL from server URL
-     */
-    static String buildApiUrl(const String& serverUrl);
-
     /**
-     * @brief Get battery voltage as string
+     * @brief Keep an interrupted image download on SD for the next wake
      *
-     * Uses BatteryMonitor SDK to read current voltage.
+     * Called before deep sleep when the wake budget ran out mid-download.
+     * Writes the bytes received so far and their If-Range validator to the
+     * card under an SdBus::Scope. The next download of the same image URL
+     * reloads them and resumes with a Range request.
      *
-     * @return Battery voltage in volts as String, or "0.0" if not available
+     * @return true if a partial image was saved; false if there was none or
+     *         the card was unavailable
      */
-    static String getBatteryVoltage();
+    static bool savePartialImage();
+
+    // Panel-sized 1-bit BMP (~47 KB at 800x480) plus 3 KB slack, in whole KB
+    static constexpr size_t MAX_IMAGE_SIZE =
+        ((62 + ((Panel::WIDTH + 31u) / 32u) * 4u * Panel::HEIGHT + 1023u) / 1024u + 3u) * 1024u;
+    static constexpr size_t RESPONSE_BUFFER_SIZE = 2048;       // /api/display JSON body
 
+    static constexpr uint32_t API_TIMEOUT_MS = 30000;     // 30 seconds for API call
+    static constexpr uint32_t FAILOVER_TIMEOUT_MS = 8000;  // Read timeout when another server is left to try
+    static constexpr int32_t SERVER_CONNECT_TIMEOUT_MS = 3000;
+    static constexpr uint32_t IMAGE_TIMEOUT_MS = 60000;    // 60 seconds for image download
+    static constexpr uint32_t IMAGE_INACTIVITY_MS = 10000; // Body stall before giving up (and resuming)
+    static constexpr uint8_t MAX_DOWNLOAD_ATTEMPTS = 3;
+    static constexpr const char* FW_VERSION = "0.1.0";
+
+private:
     /**
-     * @brief Get WiFi RSSI as string
-     *
-     * @return RSSI in dBm as String, or "0" if not connected
+     * @brief Battery voltage from the BatteryMonitor, or 0 if none was set
      */
-    static String getWifiRssi();
+    static double batteryVolts();
 
     /**
-     * @brief Parse JSON response from API
-     *
-     * @param responseBody JSON string from API
-     * @param imageUrl Output parameter for image URL
-     * @param refreshRate Output parameter for refresh rate
-     * @param trmnlStatus Output parameter for TRMNL status code
-     * @return ApiResult Result of parsing operation
+     * @brief WiFi RSSI in dBm, or 0 if not connected
      */
-    static ApiResult parseApiResponse(const String& responseBody,
-                                       String& imageUrl,
-                                       uint32_t& refreshRate,
-                                       TrmnlStatus& trmnlStatus);
+    static int wifiRssi();
 
     /**
      * @brief Download image from URL into buffer
      *
+     * Bytes received before a stall or dropped connection are kept, and the
+     * download resumes with "Range: bytes=N-" (plus If-Range when the server
+     * sent a strong ETag or Last-Modified), up to MAX_DOWNLOAD_ATTEMPTS times
+     * per call. The partial image also survives into the next call in the
+     * same boot (e.g. a retry from the menu), and deep sleep once
+     * savePartialImage() has put it on SD.
+     *
+     * The body is read with BulkReader. Unless config.downloadPowerSave is
+     * set, WiFi modem sleep is off for the transfer.
+     *
      * @param imageUrl Full URL to image
-     * @param imageData Output vector for image data
+     * @param imageData Output pointer to the image in the static image buffer
+     * @param imageSize Output image size in bytes
      * @param config TrmnlConfig for TLS settings
      * @return ApiResult Result of download operation
      */
-    static ApiResult downloadImage(const String& imageUrl,
-                                   std::vector<uint8_t>& imageData,
+    static ApiResult downloadImage(const char* imageUrl,
+                                   const uint8_t*& imageData,
+                                   size_t& imageSize,
                                    const TrmnlConfig& config);
 
-    static constexpr uint32_t API_TIMEOUT_MS = 30000;     // 30 seconds for API call
-    static constexpr uint32_t IMAGE_TIMEOUT_MS = 60000;    // 60 seconds for image download
-    static constexpr size_t MAX_IMAGE_SIZE = 10 * 1024 * 1024;  // 10 MB max image size
-     static constexpr const char* FW_VERSION = "0.1.0";
+    /**
+     * @brief One GET of the image, continuing the partial download if there is one
+     */
+    static ApiResult downloadImageAttempt(const char* imageUrl, const TrmnlConfig& config);
 };
@@ -0,0 +1,36 @@
+#include "ApiRequest.h"
+
+#include <stdio.h>
+
+#include "ImageRenderer.h"
+
+ApiRequest::DisplayHeaders::DisplayHeaders(const TrmnlConfig& config, const DeviceState& state) {
+    snprintf(refreshRate_, sizeof(refreshRate_), "%u", static_cast<unsigned>(state.refreshRate));
+    if (state.batteryVolts > 0.0) {
+        snprintf(batteryVoltage_, sizeof(batteryVoltage_), "%.2f", state.batteryVolts);
+    } else {
+        strlcpy(batteryVoltage_, "0.0", sizeof(batteryVoltage_));
+    }
+    snprintf(rssi_, sizeof(rssi_), "%d", state.rssi);
+
+    headers_[0] = {"ID", config.deviceId.c_str()};
+    headers_[1] = {"Access-Token", config.apiKey.c_str()};
+    headers_[2] = {"Refresh-Rate", refreshRate_};
+    headers_[3] = {"Battery-Voltage", batteryVoltage_};
+    headers_[4] = {"FW-Version", ApiClient::FW_VERSION};
+    headers_[5] = {"RSSI", rssi_};
+    headers_[6] = {"Energy-Summary", state.energySummary};
+}
+
+bool ApiRequest::buildUrl(char* out, const size_t size, const String& serverUrl, const char* path) {
+    int baseLength = static_cast<int>(serverUrl.length());
+    if (serverUrl.endsWith("/")) {
+        baseLength--;
+    }
+    const int n = snprintf(out, size, "%.*s%s", baseLength, serverUrl.c_str(), path);
+    return n > 0 && static_cast<size_t>(n) < size;
+}
+
+void ApiRequest::formatImageAccept(char* out, const size_t size) {
+    snprintf(out, size, "%s, image/bmp;q=0.9", ImageRenderer::FRAMEBUFFER_CONTENT_TYPE);
+}
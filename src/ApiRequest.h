@@ -0,0 +1,70 @@
+#pragma once
+
+#include <Arduino.h>
+
+#include "ApiClient.h"
+
+/**
+ * @brief One header of an outgoing request
+ */
+struct ApiHeader {
+    const char* name;
+    const char* value;
+};
+
+/**
+ * @brief Request construction for the TRMNL API
+ *
+ * Kept apart from ApiClient, like ApiResponseParser, so it has no network
+ * dependencies: tools/loadgen builds it on the host and sends exactly the
+ * URLs and headers the firmware sends.
+ */
+class ApiRequest {
+public:
+    /**
+     * @brief Device readings reported with each /api/display request
+     */
+    struct DeviceState {
+        uint32_t refreshRate;       ///< Interval planned on the previous wake, else refresh_interval
+        double batteryVolts;        ///< 0 if unknown
+        int rssi;                   ///< dBm, 0 if not connected
+        const char* energySummary;  ///< EnergyMeter::formatSummary() text
+    };
+
+    /**
+     * @brief Headers for GET /api/display
+     *
+     * Holds the formatted values, so the pointers stay valid as long as the
+     * object does. Not copyable: the copied pointers would still point into
+     * the original.
+     */
+    class DisplayHeaders {
+    public:
+        static constexpr size_t COUNT = 7;
+
+        DisplayHeaders(const TrmnlConfig& config, const DeviceState& state);
+        DisplayHeaders(const DisplayHeaders&) = delete;
+        DisplayHeaders& operator=(const DisplayHeaders&) = delete;
+
+        const ApiHeader* begin() const { return headers_; }
+        const ApiHeader* end() const { return headers_ + COUNT; }
+
+    private:
+        char refreshRate_[12];
+        char batteryVoltage_[12];
+        char rssi_[8];
+        ApiHeader headers_[COUNT];
+    };
+
+    /**
+     * @brief Build full API URL from server URL and endpoint path
+     *
+     * @return false if the result did not fit in size bytes
+     */
+    static bool buildUrl(char* out, size_t size, const String& serverUrl, const char* path);
+
+    /**
+     * @brief Accept header for the image request: the raw framebuffer format first, BMP as fallback
+     */
+    static void formatImageAccept(char* out, size_t size);
+};
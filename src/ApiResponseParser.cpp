@@ -0,0 +1,78 @@
+#include "ApiResponseParser.h"
+
+#include <stdlib.h>
+#include <string.h>
+
+#include "ArenaAllocator.h"
+
+static uint8_t jsonArena[ApiResponseParser::JSON_ARENA_SIZE];
+
+ApiResult ApiResponseParser::parse(const char* responseBody,
+                                  const size_t length,
+                                  char* imageUrl,
+                                  uint32_t& refreshRate,
+                                  TrmnlStatus& trmnlStatus,
+                                  FirmwareUpdate& firmware) {
+    ArenaAllocator arena(jsonArena, sizeof(jsonArena));
+    JsonDocument doc(&arena);
+    DeserializationError error = deserializeJson(doc, responseBody, length);
+
+    if (error) {
+        char errorMsg[128];
+        snprintf(errorMsg, sizeof(errorMsg), "JSON parse error: %s", error.c_str());
+        return ApiResult(ApiError::JSON_PARSE_FAILED, errorMsg);
+    }
+
+    if (!doc["status"].is<int>()) {
+        return ApiResult(ApiError::MISSING_REQUIRED_FIELD,
+                          "Missing required field: status");
+    }
+
+    // Firmware updates may be offered with any status, including 202.
+    if (doc["update_firmware"].is<bool>() && doc["update_firmware"].as<bool>() &&
+        doc["firmware_url"].is<const char*>()) {
+        // An over-long URL or checksum is dropped; OtaUpdater then refuses the update.
+        firmware.available = strlcpy(firmware.url, doc["firmware_url"].as<const char*>(), sizeof(firmware.url)) <
+                             sizeof(firmware.url);
+        if (doc["firmware_sha256"].is<const char*>() &&
+            strlcpy(firmware.sha256, doc["firmware_sha256"].as<const char*>(), sizeof(firmware.sha256)) >=
+                sizeof(firmware.sha256)) {
+            firmware.sha256[0] = '\0';
+        }
+    }
+
+    {
+        const int status = doc["status"].as<int>();
+        trmnlStatus = static_cast<TrmnlStatus>(status);
+        if (status == static_cast<int>(TrmnlStatus::NO_UPDATE)) {
+            return ApiResult(ApiError::SUCCESS, "");
+        }
+        if (status != static_cast<int>(TrmnlStatus::SUCCESS)) {
+            char msg[96];
+            snprintf(msg, sizeof(msg), "TRMNL status error: %d", status);
+            return ApiResult(ApiError::HTTP_REQUEST_FAILED, msg);
+        }
+    }
+
+    if (doc["image_url"].is<const char*>()) {
+        if (strlcpy(imageUrl, doc["image_url"].as<const char*>(), MAX_URL_LENGTH) >= MAX_URL_LENGTH) {
+            imageUrl[0] = '\0';
+            return ApiResult(ApiError::INVALID_URL, "image_url too long");
+        }
+    } else {
+        return ApiResult(ApiError::MISSING_REQUIRED_FIELD,
+                          "Missing required field: image_url");
+    }
+
+    if (doc["refresh_rate"].is<const char*>()) {
+        const char* rr = doc["refresh_rate"].as<const char*>();
+        refreshRate = rr ? static_cast<uint32_t>(strtoul(rr, nullptr, 10)) : 0;
+    } else if (doc["refresh_rate"].is<int>()) {
+        refreshRate = static_cast<uint32_t>(doc["refresh_rate"].as<int>());
+    }
+    if (refreshRate == 0) {
+        refreshRate = 1800;
+    }
+
+    return ApiResult(ApiError::SUCCESS, "");
+}
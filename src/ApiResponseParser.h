@@ -0,0 +1,36 @@
+#pragma once
+
+#include <Arduino.h>
+
+#include "ApiClient.h"
+
+/**
+ * @brief Parser for the /api/display JSON response
+ *
+ * Kept apart from ApiClient so it has no network dependencies and can be
+ * built on the host by tools/bench. Parses into a static ArenaAllocator
+ * pool, never the heap. Input is untrusted server data: every string is
+ * copied into a bounded buffer or rejected.
+ */
+class ApiResponseParser {
+public:
+    /**
+     * @brief Parse JSON response from API
+     *
+     * @param responseBody JSON text from API
+     * @param length Length of responseBody in bytes
+     * @param imageUrl Output parameter for image URL (MAX_URL_LENGTH bytes)
+     * @param refreshRate Output parameter for refresh rate
+     * @param trmnlStatus Output parameter for TRMNL status code
+     * @param firmware Output parameter for a pending firmware update
+     * @return ApiResult Result of parsing operation
+     */
+    static ApiResult parse(const char* responseBody,
+                           size_t length,
+                           char* imageUrl,
+                           uint32_t& refreshRate,
+                           TrmnlStatus& trmnlStatus,
+                           FirmwareUpdate& firmware);
+
+    static constexpr size_t JSON_ARENA_SIZE = 4096;  // ArduinoJson pools + strings for the parsed body
+};
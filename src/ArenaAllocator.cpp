@@ -0,0 +1,47 @@
+#include "ArenaAllocator.h"
+
+#include <string.h>
+
+#include <algorithm>
+
+void* ArenaAllocator::allocate(const size_t size) {
+    const size_t aligned = align(size);
+    if (aligned > capacity_ - used_) {
+        return nullptr;
+    }
+    last_ = used_;
+    used_ += aligned;
+    return buffer_ + last_;
+}
+
+void ArenaAllocator::deallocate(void* ptr) {
+    // Only the most recent block can be given back.
+    if (ptr == buffer_ + last_ && used_ > last_) {
+        used_ = last_;
+    }
+}
+
+void* ArenaAllocator::reallocate(void* ptr, const size_t newSize) {
+    if (ptr == nullptr) {
+        return allocate(newSize);
+    }
+
+    // The most recent block can grow or shrink in place.
+    if (ptr == buffer_ + last_) {
+        const size_t aligned = align(newSize);
+        if (aligned > capacity_ - last_) {
+            return nullptr;
+        }
+        used_ = last_ + aligned;
+        return ptr;
+    }
+
+    // Older blocks move to the end. The old size isn't tracked, so copy what
+    // fits: ArduinoJson only grows blocks, and never past the arena end.
+    const size_t oldOffset = static_cast<size_t>(static_cast<uint8_t*>(ptr) - buffer_);
+    void* moved = allocate(newSize);
+    if (moved != nullptr) {
+        memmove(moved, ptr, std::min(newSize, last_ - oldOffset));
+    }
+    return moved;
+}
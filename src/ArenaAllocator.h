@@ -0,0 +1,32 @@
+#pragma once
+
+#include <ArduinoJson.h>
+#include <stddef.h>
+
+/**
+ * @brief ArduinoJson allocator backed by a fixed buffer
+ *
+ * Bump allocation over caller-provided storage, so parsing a response never
+ * touches the heap. Memory is only reclaimed by reset() (or when the most
+ * recent block is freed or resized). When the buffer runs out, allocate()
+ * returns nullptr and ArduinoJson reports NoMemory.
+ */
+class ArenaAllocator : public ArduinoJson::Allocator {
+public:
+    ArenaAllocator(uint8_t* buffer, size_t capacity) : buffer_(buffer), capacity_(capacity), used_(0), last_(0) {}
+
+    void* allocate(size_t size) override;
+    void deallocate(void* ptr) override;
+    void* reallocate(void* ptr, size_t newSize) override;
+
+    void reset() { used_ = last_ = 0; }
+    size_t used() const { return used_; }
+
+private:
+    static size_t align(size_t n) { return (n + alignof(max_align_t) - 1) & ~(alignof(max_align_t) - 1); }
+
+    uint8_t* buffer_;
+    size_t capacity_;
+    size_t used_;
+    size_t last_;  ///< Offset of the most recent allocation
+};
@@ -0,0 +1,64 @@
+#include "BulkReader.h"
+
+#include <lwip/sockets.h>
+
+#include "CachedDnsClient.h"
+#include "WakeBudget.h"
+
+uint32_t BulkReader::Stats::bytesPerSecond() const {
+    return (ms > 0) ? static_cast<uint32_t>(static_cast<uint64_t>(bytes) * 1000u / ms) : 0;
+}
+
+BulkReader::BulkReader(CachedDnsClient& client, const uint32_t inactivityMs)
+    : client_(client), inactivityMs_(inactivityMs), startMs_(millis()), lastDataMs_(startMs_), stats_() {
+}
+
+bool BulkReader::setReceiveBuffer(const int bytes) {
+    const int fd = client_.socketFd();
+    return fd >= 0 && setsockopt(fd, SOL_SOCKET, SO_RCVBUF, &bytes, sizeof(bytes)) == 0;
+}
+
+bool BulkReader::waitReadable(const uint32_t timeoutMs) {
+    const int fd = client_.socketFd();
+    if (fd < 0) {
+        return false;
+    }
+    fd_set readable;
+    FD_ZERO(&readable);
+    FD_SET(fd, &readable);
+    timeval tv;
+    tv.tv_sec = static_cast<time_t>(timeoutMs / 1000u);
+    tv.tv_usec = static_cast<suseconds_t>((timeoutMs % 1000u) * 1000u);
+    ++stats_.waits;
+    return select(fd + 1, &readable, nullptr, nullptr, &tv) > 0;
+}
+
+size_t BulkReader::read(uint8_t* dst, const size_t size) {
+    while (size > 0) {
+        // available() also lets mbedTLS pull pending ciphertext off the socket,
+        // so plaintext it already holds is never left waiting on select().
+        if (client_.available() > 0) {
+            const int r = client_.read(dst, size);
+            if (r > 0) {
+                lastDataMs_ = millis();
+                stats_.bytes += static_cast<size_t>(r);
+                stats_.ms = lastDataMs_ - startMs_;
+                ++stats_.reads;
+                return static_cast<size_t>(r);
+            }
+        }
+        if (!client_.connected()) {
+            break;
+        }
+
+        const uint32_t idleMs = millis() - lastDataMs_;
+        if (idleMs >= inactivityMs_ || WakeBudget::expired()) {
+            break;
+        }
+        // A readable socket may hold only part of a TLS record; the next
+        // available() call consumes it, so this does not spin.
+        waitReadable(WakeBudget::clamp(inactivityMs_ - idleMs));
+    }
+    stats_.ms = millis() - startMs_;
+    return 0;
+}
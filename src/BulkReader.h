@@ -0,0 +1,68 @@
+#pragma once
+
+#include <Arduino.h>
+
+class CachedDnsClient;
+
+/**
+ * @brief Blocking large-chunk reads from a TLS connection
+ *
+ * Polling available() and calling delay(1) between reads wakes the task
+ * every tick and moves whatever happens to be buffered at that moment.
+ * BulkReader instead blocks in select() on the socket until ciphertext
+ * arrives or the inactivity deadline passes. Each read() then hands mbedTLS
+ * the whole remaining destination, so a call returns a full decrypted TLS
+ * record (up to 16 KB) straight into the caller's buffer.
+ *
+ * The inactivity timeout restarts with every byte, so on its own a trickling
+ * connection could hold the download open indefinitely; reads also stop at
+ * the WakeBudget deadline.
+ *
+ * Counters are kept so the gain can be measured per download.
+ */
+class BulkReader {
+public:
+    struct Stats {
+        size_t bytes;    ///< Payload bytes read
+        uint32_t ms;     ///< From construction to the last byte (or the give-up)
+        uint32_t reads;  ///< read() calls on the client that returned data
+        uint32_t waits;  ///< Times the task blocked waiting for the socket
+
+        uint32_t bytesPerSecond() const;
+    };
+
+    /**
+     * @param client Connected client (the HTTP response body follows)
+     * @param inactivityMs Give up after this long without a byte
+     */
+    BulkReader(CachedDnsClient& client, uint32_t inactivityMs);
+
+    /**
+     * @brief Read up to size bytes into dst, blocking until at least one arrives
+     *
+     * @return Bytes read; 0 once the peer has closed, it went quiet for too long,
+     *         or the wake budget ran out
+     */
+    size_t read(uint8_t* dst, size_t size);
+
+    /**
+     * @brief Ask lwIP for a receive buffer of this size on the connection
+     *
+     * Only takes effect when the core was built with LWIP_SO_RCVBUF; the TCP
+     * window itself is fixed when lwIP is built.
+     *
+     * @return false if the option was rejected
+     */
+    bool setReceiveBuffer(int bytes);
+
+    const Stats& stats() const { return stats_; }
+
+private:
+    bool waitReadable(uint32_t timeoutMs);
+
+    CachedDnsClient& client_;
+    uint32_t inactivityMs_;
+    uint32_t startMs_;
+    uint32_t lastDataMs_;
+    Stats stats_;
+};
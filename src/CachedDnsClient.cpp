@@ -0,0 +1,44 @@
+#include "CachedDnsClient.h"
+
+#include "DnsCache.h"
+#include "WakeBudget.h"
+
+int CachedDnsClient::connect(const char* host, const uint16_t port) {
+    return connect(host, port, _timeout);
+}
+
+int CachedDnsClient::connect(const char* host, const uint16_t port, const int32_t timeout) {
+    _timeout = timeout;
+
+    IPAddress ip;
+    if (ip.fromString(host)) {
+        return connectTo(ip, port, host);
+    }
+
+    if (DnsCache::lookup(host, ip)) {
+        if (connectTo(ip, port, host)) {
+            return 1;
+        }
+        DnsCache::invalidate(host);
+    }
+
+    if (!DnsCache::resolve(host, ip, ttlSeconds_)) {
+        return 0;
+    }
+    return connectTo(ip, port, host);
+}
+
+int CachedDnsClient::connectTo(const IPAddress& ip, const uint16_t port, const char* host) {
+    if (WakeBudget::expired()) {
+        return 0;
+    }
+    // Both the TCP connect and the TLS handshake end at the wake budget deadline.
+    _timeout = WakeBudget::clamp(static_cast<uint32_t>(_timeout));
+    const uint32_t handshakeSeconds = WakeBudget::clamp(HANDSHAKE_TIMEOUT_S * 1000u) / 1000u;
+    setHandshakeTimeout(handshakeSeconds > 0 ? handshakeSeconds : 1);
+    return WiFiClientSecure::connect(ip, port, host, _CA_cert, _cert, _private_key);
+}
+
+int CachedDnsClient::socketFd() const {
+    return (sslclient != nullptr) ? sslclient->socket : -1;
+}
@@ -0,0 +1,36 @@
+#pragma once
+
+#include <WiFiClientSecure.h>
+
+/**
+ * @brief WiFiClientSecure that resolves hostnames through DnsCache
+ *
+ * HTTPClient connects with connect(host, port, timeout). This override
+ * connects to the cached IP but still passes the hostname through for SNI
+ * and certificate checks; HTTPClient sends the Host header from the URL as
+ * usual. If the cached address doesn't answer, the entry is dropped and the
+ * host is resolved again.
+ *
+ * The connect and TLS handshake timeouts are cut to what is left of the
+ * WakeBudget, and no connection is attempted once it has run out.
+ */
+class CachedDnsClient : public WiFiClientSecure {
+public:
+    explicit CachedDnsClient(uint32_t ttlSeconds) : ttlSeconds_(ttlSeconds) {}
+
+    using WiFiClientSecure::connect;
+    int connect(const char* host, uint16_t port) override;
+    int connect(const char* host, uint16_t port, int32_t timeout) override;
+
+    /**
+     * @brief Underlying socket descriptor, or -1 when not connected
+     */
+    int socketFd() const;
+
+    static constexpr uint32_t HANDSHAKE_TIMEOUT_S = 120;  ///< WiFiClientSecure's default
+
+private:
+    int connectTo(const IPAddress& ip, uint16_t port, const char* host);
+
+    uint32_t ttlSeconds_;
+};
@@ -1,9 +1,75 @@
 #include "ConfigLoader.h"
 #include <SDCardManager.h>
 #include <WiFi.h>
+#include <esp_rom_crc.h>
 
 TrmnlConfig ConfigLoader::config;
 
+// Compact binary copy of TrmnlConfig kept in RTC memory across deep sleep.
+// Bump SNAPSHOT_VERSION whenever the layout or TrmnlConfig changes.
+struct ConfigSnapshot {
+    uint32_t magic;
+    uint16_t version;
+    uint16_t size;
+    uint32_t sourceFingerprint;  ///< CRC32 of the config file's size + mtime
+    char wifiSsid[TrmnlConfig::MAX_WIFI_PROFILES][33];  ///< Unused entries are empty
+    char wifiPassword[TrmnlConfig::MAX_WIFI_PROFILES][65];
+    char serverUrls[TrmnlConfig::MAX_SERVER_URLS][128];  ///< Unused entries are empty
+    char apiKey[72];
+    char deviceId[40];
+    uint32_t refreshInterval;
+    bool useInsecureTls;
+    bool standaloneMode;
+    bool batteryAwareRefresh;
+    uint16_t quietHoursStartMin;
+    uint16_t quietHoursEndMin;
+    int16_t utcOffsetMinutes;
+    uint32_t wakeAlignSeconds;
+    uint32_t wakeBudgetSeconds;
+    uint32_t dnsCacheTtlSeconds;
+    uint8_t statusBar;
+    uint8_t screenCacheSize;
+    uint16_t downloadRcvBuf;
+    bool downloadPowerSave;
+    uint8_t energyModel[sizeof(EnergyModel)];  ///< Raw copy; EnergyModel has a constructor
+    uint32_t crc;  ///< CRC32 of everything above
+};
+
+static constexpr uint32_t SNAPSHOT_MAGIC = 0x434E4647;  // "CNFG"
+static constexpr uint16_t SNAPSHOT_VERSION = 10;
+
+RTC_DATA_ATTR static ConfigSnapshot rtcSnapshot;
+
+static uint32_t snapshotCrc(const ConfigSnapshot& snap) {
+    return esp_rom_crc32_le(0, reinterpret_cast<const uint8_t*>(&snap), offsetof(ConfigSnapshot, crc));
+}
+
+static bool snapshotValid() {
+    return rtcSnapshot.magic == SNAPSHOT_MAGIC && rtcSnapshot.version == SNAPSHOT_VERSION &&
+           rtcSnapshot.size == sizeof(ConfigSnapshot) && rtcSnapshot.crc == snapshotCrc(rtcSnapshot);
+}
+
+static uint32_t fileFingerprint(FsFile& file) {
+    struct {
+        uint32_t size;
+        uint16_t date;
+        uint16_t time;
+    } stamp = {static_cast<uint32_t>(file.size()), 0, 0};
+    file.getModifyDateTime(&stamp.date, &stamp.time);
+    return esp_rom_crc32_le(0, reinterpret_cast<const uint8_t*>(&stamp), sizeof(stamp));
+}
+
+// Parse "HH:MM" into minutes after midnight. Returns false if malformed.
+static bool parseClockMinutes(const char* text, uint16_t& minutes) {
+    unsigned hours = 0;
+    unsigned mins = 0;
+    if (text == nullptr || sscanf(text, "%u:%u", &hours, &mins) != 2 || hours > 23 || mins > 59) {
+        return false;
+    }
+    minutes = static_cast<uint16_t>(hours * 60 + mins);
+    return true;
+}
+
 ConfigResult ConfigLoader::load(const char* path) {
     if (!SdMan.ready()) {
         return ConfigResult(ConfigError::SD_NOT_READY, "SD card not ready");
@@ -28,6 +94,13 @@ ConfigResult ConfigLoader::load(const char* path) {
         return ConfigResult(ConfigError::INVALID_VALUE, "Config file is empty");
     }
 
+    // Unchanged since the last successful parse: reuse the snapshot.
+    const uint32_t fingerprint = fileFingerprint(file);
+    if (snapshotValid() && rtcSnapshot.sourceFingerprint == fingerprint && loadFromSnapshot()) {
+        file.close();
+        return ConfigResult(ConfigError::SUCCESS, "Config unchanged, using RTC snapshot");
+    }
+
     std::unique_ptr<char[]> buffer(new char[fileSize + 1]);
     if (!buffer) {
         file.close();
@@ -52,9 +125,40 @@ ConfigResult ConfigLoader::load(const char* path) {
         return ConfigResult(ConfigError::JSON_PARSE_FAILED, errorMsg);
     }
 
-    config.wifiSsid = doc["wifi_ssid"].as<String>();
-    config.wifiPassword = doc["wifi_password"].as<String>();
-    config.serverUrl = doc["server_url"].as<String>();
+    // wifi_ssid/wifi_password is the first network; wifi_networks adds fallbacks in order.
+    config.wifiProfiles.clear();
+    if (!doc["wifi_ssid"].isNull() || !doc["wifi_password"].isNull()) {
+        WifiProfile profile;
+        profile.ssid = doc["wifi_ssid"].as<String>();
+        profile.password = doc["wifi_password"].as<String>();
+        config.wifiProfiles.push_back(profile);
+    }
+    if (!doc["wifi_networks"].isNull()) {
+        if (!doc["wifi_networks"].is<JsonArray>()) {
+            return ConfigResult(ConfigError::INVALID_VALUE, "wifi_networks must be a list of {\"ssid\",\"password\"}");
+        }
+        for (JsonVariant network : doc["wifi_networks"].as<JsonArray>()) {
+            if (!network.is<JsonObject>() || config.wifiProfiles.size() >= TrmnlConfig::MAX_WIFI_PROFILES) {
+                return ConfigResult(ConfigError::INVALID_VALUE, "wifi_networks must be a list of {\"ssid\",\"password\"}, up to 4 networks in total");
+            }
+            WifiProfile profile;
+            profile.ssid = network["ssid"].as<String>();
+            profile.password = network["password"].as<String>();
+            config.wifiProfiles.push_back(profile);
+        }
+    }
+    // server_url is a single URL or an ordered list for failover.
+    config.serverUrls.clear();
+    if (doc["server_url"].is<JsonArray>()) {
+        for (JsonVariant url : doc["server_url"].as<JsonArray>()) {
+            if (!url.is<const char*>() || config.serverUrls.size() >= TrmnlConfig::MAX_SERVER_URLS) {
+                return ConfigResult(ConfigError::INVALID_VALUE, "server_url must be a URL or a list of up to 3 URLs");
+            }
+            config.serverUrls.push_back(url.as<String>());
+        }
+    } else if (doc["server_url"].is<const char*>()) {
+        config.serverUrls.push_back(doc["server_url"].as<String>());
+    }
     config.apiKey = doc["api_key"].as<String>();
     config.deviceId = doc["device_id"].as<String>();
 
@@ -76,6 +180,65 @@ ConfigResult ConfigLoader::load(const char* path) {
         config.standaloneMode = false;
     }
 
+    config.energyModel = EnergyModel();
+    if (doc["energy_model"].is<JsonObject>()) {
+        JsonObject energy = doc["energy_model"];
+        EnergyModel& model = config.energyModel;
+        model.cpuMa = energy["cpu_ma"] | model.cpuMa;
+        model.radioTransferMa = energy["radio_transfer_ma"] | model.radioTransferMa;
+        model.radioListenMa = energy["radio_listen_ma"] | model.radioListenMa;
+        model.displayMa = energy["display_ma"] | model.displayMa;
+        model.idleMa = energy["idle_ma"] | model.idleMa;
+        model.lightSleepUa = energy["light_sleep_ua"] | model.lightSleepUa;
+        model.sleepUa = energy["sleep_ua"] | model.sleepUa;
+    }
+
+    config.batteryAwareRefresh = doc["battery_aware_refresh"] | true;
+    config.utcOffsetMinutes = doc["utc_offset_minutes"] | 0;
+    config.wakeAlignSeconds = doc["wake_align"] | 0u;
+    if (config.wakeAlignSeconds > 86400u) {
+        return ConfigResult(ConfigError::INVALID_VALUE, "wake_align must be 0-86400 seconds");
+    }
+    config.wakeBudgetSeconds = doc["wake_budget"] | 60u;
+    if (config.wakeBudgetSeconds > 600u) {
+        return ConfigResult(ConfigError::INVALID_VALUE, "wake_budget must be 0-600 seconds");
+    }
+    config.dnsCacheTtlSeconds = doc["dns_cache_ttl"] | 3600u;
+    config.statusBar = StatusBarPosition::OFF;
+    if (!doc["status_bar"].isNull()) {
+        const char* position = doc["status_bar"].as<const char*>();
+        if (position != nullptr && strcmp(position, "top") == 0) {
+            config.statusBar = StatusBarPosition::TOP;
+        } else if (position != nullptr && strcmp(position, "bottom") == 0) {
+            config.statusBar = StatusBarPosition::BOTTOM;
+        } else if (position == nullptr || strcmp(position, "off") != 0) {
+            return ConfigResult(ConfigError::INVALID_VALUE, "status_bar must be \"top\", \"bottom\" or \"off\"");
+        }
+    }
+    const uint32_t screenCache = doc["screen_cache"] | 0u;
+    if (screenCache > TrmnlConfig::MAX_SCREEN_CACHE) {
+        return ConfigResult(ConfigError::INVALID_VALUE, "screen_cache must be 0-16");
+    }
+    config.screenCacheSize = static_cast<uint8_t>(screenCache);
+    const uint32_t rcvBuf = doc["download_rcvbuf"] | 0u;
+    if (rcvBuf > UINT16_MAX) {
+        return ConfigResult(ConfigError::INVALID_VALUE, "download_rcvbuf must be 0-65535");
+    }
+    config.downloadRcvBuf = static_cast<uint16_t>(rcvBuf);
+    config.downloadPowerSave = doc["download_power_save"] | true;
+    config.quietHoursStartMin = 0;
+    config.quietHoursEndMin = 0;
+    if (doc["quiet_hours"].is<JsonObject>()) {
+        uint16_t start = 0;
+        uint16_t end = 0;
+        if (!parseClockMinutes(doc["quiet_hours"]["start"].as<const char*>(), start) ||
+            !parseClockMinutes(doc["quiet_hours"]["end"].as<const char*>(), end)) {
+            return ConfigResult(ConfigError::INVALID_VALUE, "quiet_hours must be {\"start\":\"HH:MM\",\"end\":\"HH:MM\"}");
+        }
+        config.quietHoursStartMin = start;
+        config.quietHoursEndMin = end;
+    }
+
     if (config.deviceId.isEmpty()) {
         config.deviceId = WiFi.macAddress();
     }
@@ -85,21 +248,122 @@ ConfigResult ConfigLoader::load(const char* path) {
         return validation;
     }
 
+    storeSnapshot(fingerprint);
     return ConfigResult(ConfigError::SUCCESS, "Config loaded successfully");
 }
 
+bool ConfigLoader::loadFromSnapshot() {
+    if (!snapshotValid()) {
+        return false;
+    }
+
+    config.wifiProfiles.clear();
+    for (size_t i = 0; i < TrmnlConfig::MAX_WIFI_PROFILES; ++i) {
+        if (rtcSnapshot.wifiSsid[i][0] != '\0') {
+            WifiProfile profile;
+            profile.ssid = rtcSnapshot.wifiSsid[i];
+            profile.password = rtcSnapshot.wifiPassword[i];
+            config.wifiProfiles.push_back(profile);
+        }
+    }
+    config.serverUrls.clear();
+    for (const char* url : rtcSnapshot.serverUrls) {
+        if (url[0] != '\0') {
+            config.serverUrls.push_back(url);
+        }
+    }
+    config.apiKey = rtcSnapshot.apiKey;
+    config.deviceId = rtcSnapshot.deviceId;
+    config.refreshInterval = rtcSnapshot.refreshInterval;
+    config.useInsecureTls = rtcSnapshot.useInsecureTls;
+    config.standaloneMode = rtcSnapshot.standaloneMode;
+    config.batteryAwareRefresh = rtcSnapshot.batteryAwareRefresh;
+    config.quietHoursStartMin = rtcSnapshot.quietHoursStartMin;
+    config.quietHoursEndMin = rtcSnapshot.quietHoursEndMin;
+    config.utcOffsetMinutes = rtcSnapshot.utcOffsetMinutes;
+    config.wakeAlignSeconds = rtcSnapshot.wakeAlignSeconds;
+    config.wakeBudgetSeconds = rtcSnapshot.wakeBudgetSeconds;
+    config.dnsCacheTtlSeconds = rtcSnapshot.dnsCacheTtlSeconds;
+    config.statusBar = static_cast<StatusBarPosition>(rtcSnapshot.statusBar);
+    config.screenCacheSize = rtcSnapshot.screenCacheSize;
+    config.downloadRcvBuf = rtcSnapshot.downloadRcvBuf;
+    config.downloadPowerSave = rtcSnapshot.downloadPowerSave;
+    memcpy(&config.energyModel, rtcSnapshot.energyModel, sizeof(EnergyModel));
+    return true;
+}
+
+void ConfigLoader::storeSnapshot(const uint32_t fingerprint) {
+    ConfigSnapshot& snap = rtcSnapshot;
+    memset(&snap, 0, sizeof(snap));
+    snap.magic = SNAPSHOT_MAGIC;
+    snap.version = SNAPSHOT_VERSION;
+    snap.size = sizeof(ConfigSnapshot);
+    snap.sourceFingerprint = fingerprint;
+
+    // Fields that don't fit are not snapshotted; the next wake reparses the file instead.
+    bool fits = config.apiKey.length() < sizeof(snap.apiKey) && config.deviceId.length() < sizeof(snap.deviceId) &&
+                config.serverUrls.size() <= TrmnlConfig::MAX_SERVER_URLS &&
+                config.wifiProfiles.size() <= TrmnlConfig::MAX_WIFI_PROFILES;
+    for (const WifiProfile& profile : config.wifiProfiles) {
+        fits = fits && profile.ssid.length() < sizeof(snap.wifiSsid[0]) &&
+               profile.password.length() < sizeof(snap.wifiPassword[0]);
+    }
+    for (const String& url : config.serverUrls) {
+        fits = fits && url.length() < sizeof(snap.serverUrls[0]);
+    }
+    if (!fits) {
+        snap.magic = 0;
+        return;
+    }
+
+    for (size_t i = 0; i < config.wifiProfiles.size(); ++i) {
+        strlcpy(snap.wifiSsid[i], config.wifiProfiles[i].ssid.c_str(), sizeof(snap.wifiSsid[i]));
+        strlcpy(snap.wifiPassword[i], config.wifiProfiles[i].password.c_str(), sizeof(snap.wifiPassword[i]));
+    }
+    for (size_t i = 0; i < config.serverUrls.size(); ++i) {
+        strlcpy(snap.serverUrls[i], config.serverUrls[i].c_str(), sizeof(snap.serverUrls[i]));
+    }
+    strlcpy(snap.apiKey, config.apiKey.c_str(), sizeof(snap.apiKey));
+    strlcpy(snap.deviceId, config.deviceId.c_str(), sizeof(snap.deviceId));
+    snap.refreshInterval = config.refreshInterval;
+    snap.useInsecureTls = config.useInsecureTls;
+    snap.standaloneMode = config.standaloneMode;
+    snap.batteryAwareRefresh = config.batteryAwareRefresh;
+    snap.quietHoursStartMin = config.quietHoursStartMin;
+    snap.quietHoursEndMin = config.quietHoursEndMin;
+    snap.utcOffsetMinutes = config.utcOffsetMinutes;
+    snap.wakeAlignSeconds = config.wakeAlignSeconds;
+    snap.wakeBudgetSeconds = config.wakeBudgetSeconds;
+    snap.dnsCacheTtlSeconds = config.dnsCacheTtlSeconds;
+    snap.statusBar = static_cast<uint8_t>(config.statusBar);
+    snap.screenCacheSize = config.screenCacheSize;
+    snap.downloadRcvBuf = config.downloadRcvBuf;
+    snap.downloadPowerSave = config.downloadPowerSave;
+    memcpy(snap.energyModel, &config.energyModel, sizeof(EnergyModel));
+    snap.crc = snapshotCrc(snap);
+}
+
 ConfigResult ConfigLoader::validateRequiredFields() {
-    if (config.wifiSsid.isEmpty()) {
+    if (config.wifiProfiles.empty()) {
         return ConfigResult(ConfigError::MISSING_REQUIRED_FIELD, "Missing required field: wifi_ssid");
     }
-
-    if (config.wifiPassword.isEmpty()) {
-        return ConfigResult(ConfigError::MISSING_REQUIRED_FIELD, "Missing required field: wifi_password");
+    for (const WifiProfile& profile : config.wifiProfiles) {
+        if (profile.ssid.isEmpty()) {
+            return ConfigResult(ConfigError::MISSING_REQUIRED_FIELD, "Missing required field: wifi_ssid");
+        }
+        if (profile.password.isEmpty()) {
+            return ConfigResult(ConfigError::MISSING_REQUIRED_FIELD, "Missing required field: wifi_password");
+        }
     }
 
-    if (config.serverUrl.isEmpty()) {
+    if (config.serverUrls.empty()) {
         return ConfigResult(ConfigError::MISSING_REQUIRED_FIELD, "Missing required field: server_url");
     }
+    for (const String& url : config.serverUrls) {
+        if (url.isEmpty()) {
+            return ConfigResult(ConfigError::INVALID_VALUE, "server_url entries must not be empty");
+        }
+    }
 
     if (config.apiKey.isEmpty()) {
         return ConfigResult(ConfigError::MISSING_REQUIRED_FIELD, "Missing required field: api_key");
@@ -2,6 +2,51 @@
 
 #include <Arduino.h>
 #include <ArduinoJson.h>
+#include <vector>
+
+/**
+ * @brief Current draw per power state, used by EnergyMeter
+ *
+ * Loaded from the optional "energy_model" object in /trmnl-config.json.
+ * Active-state values are totals for the whole board in that state;
+ * radioListenMa is added on top while the radio is up but idle.
+ */
+struct EnergyModel {
+    uint16_t cpuMa;           ///< CPU active, radio off
+    uint16_t radioTransferMa; ///< HTTP transfer in flight (radio TX/RX)
+    uint16_t radioListenMa;   ///< Radio associated/listening (adder)
+    uint16_t displayMa;       ///< Waiting on a panel refresh
+    uint16_t idleMa;          ///< delay() waits at full CPU clock
+    uint16_t lightSleepUa;    ///< Idle waits in light sleep, in microamps
+    uint16_t sleepUa;         ///< Deep sleep, in microamps
+
+    EnergyModel()
+        : cpuMa(25)
+        , radioTransferMa(110)
+        , radioListenMa(70)
+        , displayMa(28)
+        , idleMa(20)
+        , lightSleepUa(2000)
+        , sleepUa(60) {
+    }
+};
+
+/**
+ * @brief Where StatusBar draws its strip over the fetched image
+ */
+enum class StatusBarPosition : uint8_t {
+    OFF = 0,
+    TOP,
+    BOTTOM
+};
+
+/**
+ * @brief One WiFi network the device may join
+ */
+struct WifiProfile {
+    String ssid;
+    String password;
+};
 
 /**
  * @brief Configuration structure for TRMNL dashboard
@@ -9,14 +54,29 @@
  * Contains all configuration parameters loaded from /trmnl-config.json
  */
 struct TrmnlConfig {
-    String wifiSsid;         ///< WiFi SSID (required)
-    String wifiPassword;      ///< WiFi password (required)
-    String serverUrl;         ///< Server URL e.g. "https://usetrmnl.com" (required)
+    std::vector<WifiProfile> wifiProfiles; ///< WiFi networks in preference order (at least one)
+    std::vector<String> serverUrls; ///< Server URLs in preference order, e.g. "https://usetrmnl.com" (at least one)
     String apiKey;            ///< TRMNL API key (required)
     String deviceId;          ///< Custom device ID (optional, empty = use WiFi MAC)
     uint32_t refreshInterval; ///< Seconds between refreshes (default 1800)
     bool useInsecureTls;      ///< Skip TLS cert validation (default true for MVP)
     bool standaloneMode;      ///< If true, Back button ignored (no CrossPoint to return to)
+    EnergyModel energyModel;  ///< Per-state current table for energy estimates
+    bool batteryAwareRefresh; ///< Stretch the refresh interval as the battery drains (default true)
+    uint16_t quietHoursStartMin; ///< Quiet hours start, minutes after local midnight
+    uint16_t quietHoursEndMin;   ///< Quiet hours end; equal to start = disabled
+    int16_t utcOffsetMinutes;    ///< Local time offset from UTC for quiet hours
+    uint32_t wakeAlignSeconds;   ///< Show new images on local multiples of this (0 = off)
+    uint32_t wakeBudgetSeconds;  ///< Ceiling on network time per wake (0 = off)
+    uint32_t dnsCacheTtlSeconds; ///< Max age of cached DNS answers across sleeps (0 = no cache)
+    StatusBarPosition statusBar; ///< Device status strip over the image (default off)
+    uint8_t screenCacheSize;     ///< Rendered screens kept on SD for paging (0 = off)
+    uint16_t downloadRcvBuf;     ///< SO_RCVBUF for image downloads in bytes (0 = lwIP default)
+    bool downloadPowerSave;      ///< Keep WiFi modem sleep on during image downloads (default true)
+
+    static constexpr size_t MAX_WIFI_PROFILES = 4;
+    static constexpr size_t MAX_SERVER_URLS = 3;
+    static constexpr uint8_t MAX_SCREEN_CACHE = 16;
 
     /**
      * @brief Constructor with default values
@@ -24,7 +84,18 @@ struct TrmnlConfig {
     TrmnlConfig()
         : refreshInterval(1800)
         , useInsecureTls(true)
-        , standaloneMode(false) {
+        , standaloneMode(false)
+        , batteryAwareRefresh(true)
+        , quietHoursStartMin(0)
+        , quietHoursEndMin(0)
+        , utcOffsetMinutes(0)
+        , wakeAlignSeconds(0)
+        , wakeBudgetSeconds(60)
+        , dnsCacheTtlSeconds(3600)
+        , statusBar(StatusBarPosition::OFF)
+        , screenCacheSize(0)
+        , downloadRcvBuf(0)
+        , downloadPowerSave(true) {
     }
 };
 
@@ -68,6 +139,17 @@ public:
      */
     static ConfigResult load(const char* path = "/trmnl-config.json");
 
+    /**
+     * @brief Restore configuration from the RTC snapshot without touching SD
+     *
+     * The snapshot is written by every successful load() and survives deep
+     * sleep (but not power loss). Timer wakes use it to skip the SD mount and
+     * JSON parse entirely.
+     *
+     * @return true if a valid snapshot was restored
+     */
+    static bool loadFromSnapshot();
+
     /**
      * @brief Get the loaded configuration
      *
@@ -86,4 +168,9 @@ private:
      * @return ConfigResult Result with success/error status
      */
     static ConfigResult validateRequiredFields();
+
+    /**
+     * @brief Store the current config in RTC memory, tagged with the source fingerprint
+     */
+    static void storeSnapshot(uint32_t fingerprint);
 };
@@ -0,0 +1,123 @@
+#include "DnsCache.h"
+
+#include <WiFi.h>
+
+#include <string.h>
+#include <time.h>
+
+#include "Telemetry.h"
+#include "WakeBudget.h"
+
+namespace {
+
+constexpr uint32_t RTC_MAGIC = 0x444E5343;  // "DNSC"
+
+struct DnsEntry {
+    char host[DnsCache::HOST_MAX];
+    uint32_t ip;
+    uint32_t expires;  ///< System time (seconds); 0 = free slot
+};
+
+struct RtcDnsCache {
+    uint32_t magic;
+    uint32_t resolveMsAvg;  ///< EWMA of uncached lookups, used to estimate time saved
+    DnsEntry entries[DnsCache::CAPACITY];
+};
+
+RTC_DATA_ATTR RtcDnsCache rtcCache;
+
+// Since the last recordTelemetry() call, normally one per wake.
+uint16_t wakeLookups = 0;
+uint16_t wakeHits = 0;
+
+void ensureCache() {
+    if (rtcCache.magic != RTC_MAGIC) {
+        memset(&rtcCache, 0, sizeof(rtcCache));
+        rtcCache.magic = RTC_MAGIC;
+    }
+}
+
+uint32_t nowSeconds() {
+    return static_cast<uint32_t>(time(nullptr));
+}
+
+DnsEntry* find(const char* host) {
+    for (DnsEntry& entry : rtcCache.entries) {
+        if (entry.expires != 0 && strncmp(entry.host, host, sizeof(entry.host)) == 0) {
+            return &entry;
+        }
+    }
+    return nullptr;
+}
+
+}  // namespace
+
+bool DnsCache::lookup(const char* host, IPAddress& ip) {
+    ensureCache();
+    wakeLookups++;
+
+    DnsEntry* entry = find(host);
+    if (entry == nullptr) {
+        return false;
+    }
+    if (nowSeconds() >= entry->expires) {
+        entry->expires = 0;
+        return false;
+    }
+    ip = IPAddress(entry->ip);
+    wakeHits++;
+    return true;
+}
+
+bool DnsCache::resolve(const char* host, IPAddress& ip, const uint32_t ttlSeconds) {
+    ensureCache();
+
+    // hostByName() takes no timeout, so don't start one that could outlive the wake budget.
+    if (WakeBudget::remainingMs() < RESOLVE_TIMEOUT_MS) {
+        return false;
+    }
+    const uint32_t start = millis();
+    if (!WiFi.hostByName(host, ip)) {
+        return false;
+    }
+    const uint32_t elapsed = millis() - start;
+    rtcCache.resolveMsAvg = rtcCache.resolveMsAvg == 0 ? elapsed : (3 * rtcCache.resolveMsAvg + elapsed) / 4;
+
+    if (ttlSeconds == 0 || strlen(host) >= HOST_MAX) {
+        return true;
+    }
+
+    // Reuse the host's slot, else a free one, else the one expiring first.
+    DnsEntry* slot = find(host);
+    if (slot == nullptr) {
+        slot = &rtcCache.entries[0];
+        for (DnsEntry& entry : rtcCache.entries) {
+            if (entry.expires < slot->expires) {
+                slot = &entry;
+            }
+        }
+    }
+    strlcpy(slot->host, host, sizeof(slot->host));
+    slot->ip = static_cast<uint32_t>(ip);
+    slot->expires = nowSeconds() + ttlSeconds;
+    return true;
+}
+
+void DnsCache::invalidate(const char* host) {
+    ensureCache();
+    DnsEntry* entry = find(host);
+    if (entry != nullptr) {
+        entry->expires = 0;
+    }
+}
+
+void DnsCache::recordTelemetry() {
+    if (wakeLookups == 0) {
+        return;
+    }
+    const uint32_t savedMs = wakeHits * rtcCache.resolveMsAvg;
+    Serial.printf("DNS cache: %u/%u hits, ~%u ms saved\n", wakeHits, wakeLookups, static_cast<unsigned>(savedMs));
+    Telemetry::record(Telemetry::Event::DNS_CACHE, wakeHits, wakeLookups, static_cast<int32_t>(savedMs));
+    wakeLookups = 0;
+    wakeHits = 0;
+}
@@ -0,0 +1,46 @@
+#pragma once
+
+#include <Arduino.h>
+
+/**
+ * @brief Hostname -> IPv4 cache kept in RTC memory across deep sleep
+ *
+ * Saves the DNS round-trips for the API and image hosts on warm wakes.
+ * lwIP's resolver does not hand the record TTL to callers, so entries live
+ * for the configured dns_cache_ttl cap instead. Expiry uses system time,
+ * which keeps running through deep sleep. Entries stored before WallClock
+ * first set the clock simply expire at that jump.
+ *
+ * Used through CachedDnsClient, which invalidates an entry and re-resolves
+ * when connecting to the cached address fails.
+ */
+class DnsCache {
+public:
+    /**
+     * @brief Look up a cached, unexpired address
+     *
+     * @return true on a hit; counted in this wake's statistics
+     */
+    static bool lookup(const char* host, IPAddress& ip);
+
+    /**
+     * @brief Resolve through DNS and cache the result for ttlSeconds (0 = don't cache)
+     *
+     * Fails without querying when less than RESOLVE_TIMEOUT_MS is left of the WakeBudget.
+     */
+    static bool resolve(const char* host, IPAddress& ip, uint32_t ttlSeconds);
+
+    /**
+     * @brief Drop the entry for host, if any
+     */
+    static void invalidate(const char* host);
+
+    /**
+     * @brief Record this wake's hit count and estimated time saved in Telemetry
+     */
+    static void recordTelemetry();
+
+    static constexpr size_t CAPACITY = 4;
+    static constexpr size_t HOST_MAX = 64;  ///< Including terminator; longer hosts are not cached
+    static constexpr uint32_t RESOLVE_TIMEOUT_MS = 4000;  ///< hostByName()'s fixed wait in the core
+};
@@ -0,0 +1,155 @@
+#include "EnergyMeter.h"
+
+#include <esp_sleep.h>
+
+#include <string.h>
+
+namespace {
+
+struct RtcEnergyRing {
+    uint32_t magic;
+    uint8_t version;
+    uint8_t head;   ///< Next slot to write
+    uint8_t count;  ///< Valid records (<= RING_SIZE)
+    uint8_t reserved;
+    uint32_t nextSeq;
+    EnergyMeter::WakeEnergyRecord records[EnergyMeter::RING_SIZE];
+};
+
+RTC_DATA_ATTR RtcEnergyRing rtcRing;
+
+EnergyMeter::State currentState = EnergyMeter::State::CPU;
+uint32_t stateStartMs = 0;
+uint32_t stateMs[static_cast<size_t>(EnergyMeter::State::COUNT)] = {0};
+uint32_t radioOnAtMs = 0;
+uint32_t radioMs = 0;
+bool radioIsOn = false;
+// Light sleep overwrites the wake cause, so keep the deep-sleep one.
+uint8_t wakeCause = 0;
+
+void ensureRing() {
+    if (rtcRing.magic != EnergyMeter::RECORD_MAGIC || rtcRing.version != EnergyMeter::RECORD_VERSION ||
+        rtcRing.head >= EnergyMeter::RING_SIZE || rtcRing.count > EnergyMeter::RING_SIZE) {
+        memset(&rtcRing, 0, sizeof(rtcRing));
+        rtcRing.magic = EnergyMeter::RECORD_MAGIC;
+        rtcRing.version = EnergyMeter::RECORD_VERSION;
+    }
+}
+
+uint32_t awakeMs(const EnergyMeter::WakeEnergyRecord& record) {
+    uint32_t total = 0;
+    for (size_t i = 0; i < static_cast<size_t>(EnergyMeter::State::COUNT); ++i) {
+        total += record.stateMs[i];
+    }
+    return total;
+}
+
+}  // namespace
+
+void EnergyMeter::begin() {
+    ensureRing();
+    currentState = State::CPU;
+    // Time before setup() (ROM/bootloader/app init) is charged to the CPU.
+    stateStartMs = 0;
+    memset(stateMs, 0, sizeof(stateMs));
+    radioMs = 0;
+    radioIsOn = false;
+    wakeCause = static_cast<uint8_t>(esp_sleep_get_wakeup_cause());
+}
+
+EnergyMeter::State EnergyMeter::enter(const State state) {
+    const uint32_t now = millis();
+    stateMs[static_cast<size_t>(currentState)] += now - stateStartMs;
+    stateStartMs = now;
+
+    const State previous = currentState;
+    currentState = state;
+    return previous;
+}
+
+void EnergyMeter::radioOn() {
+    if (!radioIsOn) {
+        radioIsOn = true;
+        radioOnAtMs = millis();
+    }
+}
+
+void EnergyMeter::radioOff() {
+    if (radioIsOn) {
+        radioIsOn = false;
+        radioMs += millis() - radioOnAtMs;
+    }
+}
+
+void EnergyMeter::commit(const uint32_t sleepSeconds, const double batteryVolts) {
+    ensureRing();
+    enter(currentState);  // flush the running state
+    radioOff();
+
+    WakeEnergyRecord& record = rtcRing.records[rtcRing.head];
+    record.seq = rtcRing.nextSeq++;
+    memcpy(record.stateMs, stateMs, sizeof(record.stateMs));
+    record.radioOnMs = radioMs;
+    record.sleepSeconds = sleepSeconds;
+    record.batteryMv = static_cast<uint16_t>(batteryVolts * 1000.0);
+    record.wakeCause = wakeCause;
+    record.flags = 0;
+
+    rtcRing.head = static_cast<uint8_t>((rtcRing.head + 1) % RING_SIZE);
+    if (rtcRing.count < RING_SIZE) {
+        rtcRing.count++;
+    }
+}
+
+uint32_t EnergyMeter::estimateMicroAh(const WakeEnergyRecord& record, const EnergyModel& model) {
+    // mA * ms = uA * s; divide by 3600 for uAh.
+    uint64_t uAs = 0;
+    uAs += static_cast<uint64_t>(record.stateMs[static_cast<size_t>(State::CPU)]) * model.cpuMa;
+    uAs += static_cast<uint64_t>(record.stateMs[static_cast<size_t>(State::TRANSFER)]) * model.radioTransferMa;
+    uAs += static_cast<uint64_t>(record.stateMs[static_cast<size_t>(State::DISPLAY)]) * model.displayMa;
+    uAs += static_cast<uint64_t>(record.stateMs[static_cast<size_t>(State::IDLE)]) * model.idleMa;
+    // Light sleep is modelled in microamps: ms * uA / 1000 = uA * s.
+    uAs += static_cast<uint64_t>(record.stateMs[static_cast<size_t>(State::LIGHT_SLEEP)]) * model.lightSleepUa / 1000u;
+
+    // Radio listening adds on top of whatever the CPU is doing, except during
+    // transfers whose current already includes the radio.
+    const uint32_t transferMs = record.stateMs[static_cast<size_t>(State::TRANSFER)];
+    const uint32_t listenMs = (record.radioOnMs > transferMs) ? (record.radioOnMs - transferMs) : 0;
+    uAs += static_cast<uint64_t>(listenMs) * model.radioListenMa;
+
+    uAs += static_cast<uint64_t>(record.sleepSeconds) * model.sleepUa;
+
+    return static_cast<uint32_t>(uAs / 3600u);
+}
+
+void EnergyMeter::formatSummary(const EnergyModel& model, char* out, const size_t outSize) {
+    ensureRing();
+
+    uint64_t sumUah = 0;
+    uint64_t sumAwake = 0;
+    uint64_t sumRadio = 0;
+    for (size_t i = 0; i < rtcRing.count; ++i) {
+        const WakeEnergyRecord& record = rtcRing.records[i];
+        sumUah += estimateMicroAh(record, model);
+        sumAwake += awakeMs(record);
+        sumRadio += record.radioOnMs;
+    }
+
+    const uint32_t n = rtcRing.count;
+    snprintf(out, outSize, "n=%u avg_uah=%u avg_awake_ms=%u avg_radio_ms=%u", static_cast<unsigned>(n),
+             static_cast<unsigned>(n ? sumUah / n : 0), static_cast<unsigned>(n ? sumAwake / n : 0),
+             static_cast<unsigned>(n ? sumRadio / n : 0));
+}
+
+void EnergyMeter::dump(Print& out) {
+    ensureRing();
+
+    static const char HEX_DIGITS[] = "0123456789abcdef";
+    const uint8_t* bytes = reinterpret_cast<const uint8_t*>(&rtcRing);
+    out.print("ENERGY ");
+    for (size_t i = 0; i < sizeof(rtcRing); ++i) {
+        const char pair[3] = {HEX_DIGITS[bytes[i] >> 4], HEX_DIGITS[bytes[i] & 0x0F], '\0'};
+        out.print(pair);
+    }
+    out.println();
+}
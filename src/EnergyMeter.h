@@ -0,0 +1,98 @@
+#pragma once
+
+#include <Arduino.h>
+
+#include "ConfigLoader.h"
+
+/**
+ * @brief Per-wake energy accounting
+ *
+ * The main task's timeline is split into exclusive states (CPU, network
+ * transfer, display busy, idle waits). Radio-on time is tracked separately
+ * because association and DHCP overlap the other states.
+ *
+ * At the end of each wake the totals are committed as one WakeEnergyRecord
+ * into a fixed-size ring buffer in RTC memory, which survives deep sleep.
+ * The layout below is decoded by tools/energy_decode.py, so bump
+ * RECORD_VERSION whenever it changes.
+ */
+class EnergyMeter {
+public:
+    enum class State : uint8_t {
+        CPU = 0,   ///< CPU active (default)
+        TRANSFER,  ///< HTTP request/response in flight (radio TX/RX)
+        DISPLAY,   ///< Blocked on the panel refresh
+        IDLE,      ///< Deliberate waits (USB window, uptime padding, menus)
+        LIGHT_SLEEP,  ///< Idle waits spent in light sleep (radio off, no USB host)
+        COUNT
+    };
+
+    struct WakeEnergyRecord {
+        uint32_t seq;              ///< Wake sequence number
+        uint32_t stateMs[5];       ///< Indexed by State
+        uint32_t radioOnMs;        ///< Radio powered, overlaps the states above
+        uint32_t sleepSeconds;     ///< Deep sleep requested at the end of the wake
+        uint16_t batteryMv;        ///< Battery voltage at commit
+        uint8_t wakeCause;         ///< esp_sleep_wakeup_cause_t
+        uint8_t flags;             ///< Reserved
+    };
+    static_assert(sizeof(WakeEnergyRecord) == 36, "WakeEnergyRecord layout is decoded on the host");
+
+    static constexpr uint32_t RECORD_MAGIC = 0x454E5247;  // "ENRG"
+    static constexpr uint8_t RECORD_VERSION = 2;
+    static constexpr size_t RING_SIZE = 16;
+
+    /**
+     * @brief RAII helper: enter a state for the lifetime of the scope
+     */
+    class Scope {
+    public:
+        explicit Scope(State state) : _previous(EnergyMeter::enter(state)) {}
+        ~Scope() { EnergyMeter::enter(_previous); }
+
+    private:
+        State _previous;
+    };
+
+    /**
+     * @brief Start accounting for this wake (call first in setup())
+     */
+    static void begin();
+
+    /**
+     * @brief Switch the main-task state
+     *
+     * @return State that was active before the switch
+     */
+    static State enter(State state);
+
+    static void radioOn();
+    static void radioOff();
+
+    /**
+     * @brief Close the current wake and append it to the RTC ring buffer
+     *
+     * @param sleepSeconds Deep sleep duration that follows this wake
+     * @param batteryVolts Battery voltage at the end of the wake
+     */
+    static void commit(uint32_t sleepSeconds, double batteryVolts);
+
+    /**
+     * @brief Estimated charge for one wake cycle, including the following sleep
+     *
+     * @return Charge in microamp-hours
+     */
+    static uint32_t estimateMicroAh(const WakeEnergyRecord& record, const EnergyModel& model);
+
+    /**
+     * @brief Format a rolling summary over the committed records
+     *
+     * Example: "n=16 avg_uah=412 avg_awake_ms=9120 avg_radio_ms=3100"
+     */
+    static void formatSummary(const EnergyModel& model, char* out, size_t outSize);
+
+    /**
+     * @brief Hex-dump the RTC ring buffer as a single "ENERGY <hex>" line
+     */
+    static void dump(Print& out);
+};
@@ -2,21 +2,32 @@
 
 #include <stdio.h>
 
+#include "EnergyMeter.h"
+#include "PanelGeometry.h"
 #include "TextDraw.h"
 
 namespace ErrorDisplay {
 
+namespace {
+
+void present(EInkDisplay& display) {
+    EnergyMeter::Scope busy(EnergyMeter::State::DISPLAY);
+    display.displayBuffer(EInkDisplay::FULL_REFRESH);
+}
+
+}  // namespace
+
 void showNoSdCard(EInkDisplay& display) {
     display.clearScreen(0xFF);
 
     const char* title = "ERROR";
     const char* message = "Insert SD Card";
 
-    int16_t centerY = static_cast<int16_t>(EInkDisplay::DISPLAY_HEIGHT / 2);
+    int16_t centerY = static_cast<int16_t>(Panel::HEIGHT / 2);
     TextDraw::drawCenteredString(display, title, centerY - 32);
     TextDraw::drawCenteredString(display, message, centerY + 8);
 
-    display.displayBuffer(EInkDisplay::FULL_REFRESH);
+    present(display);
 }
 
 void showNoConfig(EInkDisplay& display) {
@@ -26,12 +37,12 @@ void showNoConfig(EInkDisplay& display) {
     const char* message = "Config file missing";
     const char* path = "Expected: /trmnl-config.json";
 
-    int16_t centerY = static_cast<int16_t>(EInkDisplay::DISPLAY_HEIGHT / 2);
+    int16_t centerY = static_cast<int16_t>(Panel::HEIGHT / 2);
     TextDraw::drawCenteredString(display, title, centerY - 48);
     TextDraw::drawCenteredString(display, message, centerY - 8);
     TextDraw::drawCenteredString(display, path, centerY + 24);
 
-    display.displayBuffer(EInkDisplay::FULL_REFRESH);
+    present(display);
 }
 
 void showWiFiError(EInkDisplay& display, const char* ssid) {
@@ -41,11 +52,11 @@ void showWiFiError(EInkDisplay& display, const char* ssid) {
     char message[64];
     snprintf(message, sizeof(message), "WiFi failed: %s", ssid);
 
-    int16_t centerY = static_cast<int16_t>(EInkDisplay::DISPLAY_HEIGHT / 2);
+    int16_t centerY = static_cast<int16_t>(Panel::HEIGHT / 2);
     TextDraw::drawCenteredString(display, title, centerY - 24);
     TextDraw::drawCenteredString(display, message, centerY + 16);
 
-    display.displayBuffer(EInkDisplay::FULL_REFRESH);
+    present(display);
 }
 
 void showApiError(EInkDisplay& display, int httpCode) {
@@ -55,11 +66,11 @@ void showApiError(EInkDisplay& display, int httpCode) {
     char message[64];
     snprintf(message, sizeof(message), "API Error: %d", httpCode);
 
-    int16_t centerY = static_cast<int16_t>(EInkDisplay::DISPLAY_HEIGHT / 2);
+    int16_t centerY = static_cast<int16_t>(Panel::HEIGHT / 2);
     TextDraw::drawCenteredString(display, title, centerY - 24);
     TextDraw::drawCenteredString(display, message, centerY + 16);
 
-    display.displayBuffer(EInkDisplay::FULL_REFRESH);
+    present(display);
 }
 
 void showGenericError(EInkDisplay& display, const char* message) {
@@ -67,11 +78,11 @@ void showGenericError(EInkDisplay& display, const char* message) {
 
     const char* title = "ERROR";
 
-    int16_t centerY = static_cast<int16_t>(EInkDisplay::DISPLAY_HEIGHT / 2);
+    int16_t centerY = static_cast<int16_t>(Panel::HEIGHT / 2);
     TextDraw::drawCenteredString(display, title, centerY - 24);
     TextDraw::drawCenteredString(display, message, centerY + 16);
 
-    display.displayBuffer(EInkDisplay::FULL_REFRESH);
+    present(display);
 }
 
 }  // namespace ErrorDisplay
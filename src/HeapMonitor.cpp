@@ -0,0 +1,31 @@
+#include "HeapMonitor.h"
+
+#include <esp_heap_caps.h>
+
+#include "Telemetry.h"
+
+void HeapMonitor::mark(const Stage stage) {
+    const size_t freeBytes = heap_caps_get_free_size(MALLOC_CAP_8BIT);
+    const size_t largestBlock = heap_caps_get_largest_free_block(MALLOC_CAP_8BIT);
+    const size_t minFree = heap_caps_get_minimum_free_size(MALLOC_CAP_8BIT);
+
+    Serial.printf("Heap [%s]: free %u, largest block %u, min ever %u\n", stageToString(stage),
+                  static_cast<unsigned>(freeBytes), static_cast<unsigned>(largestBlock), static_cast<unsigned>(minFree));
+
+    // Three args per record: the stage shares a0 with the minimum (low 8 bits).
+    const int32_t stageAndMin = static_cast<int32_t>((minFree << 8) | static_cast<uint8_t>(stage));
+    Telemetry::record(Telemetry::Event::HEAP, stageAndMin, static_cast<int32_t>(freeBytes),
+                      static_cast<int32_t>(largestBlock));
+}
+
+const char* HeapMonitor::stageToString(const Stage stage) {
+    switch (stage) {
+        case Stage::BOOT: return "boot";
+        case Stage::CONFIG: return "config";
+        case Stage::WIFI: return "wifi";
+        case Stage::API_RESPONSE: return "api_response";
+        case Stage::IMAGE_DOWNLOAD: return "image_download";
+        case Stage::RENDER: return "render";
+    }
+    return "unknown";
+}
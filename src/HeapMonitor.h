@@ -0,0 +1,30 @@
+#pragma once
+
+#include <Arduino.h>
+
+/**
+ * @brief Heap watermarks at fixed points of a wake
+ *
+ * Records free heap, the largest free block and the all-time minimum free
+ * heap as a Telemetry HEAP event, and prints them to serial. The largest
+ * free block is the number to watch: the TLS handshake needs one
+ * contiguous allocation of roughly 16-20 KB on top of everything else.
+ */
+class HeapMonitor {
+public:
+    enum class Stage : uint8_t {
+        BOOT = 0,
+        CONFIG = 1,
+        WIFI = 2,
+        API_RESPONSE = 3,
+        IMAGE_DOWNLOAD = 4,
+        RENDER = 5
+    };
+
+    /**
+     * @brief Sample the heap and record it for a stage
+     */
+    static void mark(Stage stage);
+
+    static const char* stageToString(Stage stage);
+};
@@ -1,13 +1,24 @@
 #include "ImageRenderer.h"
 
+#include <esp_rom_crc.h>
+#include <string.h>
+
 #include <algorithm>
 
+#include "EnergyMeter.h"
+#include "PanelGeometry.h"
+#include "Telemetry.h"
+
 namespace ImageRenderer {
 
 namespace {
 
-constexpr uint16_t EXPECTED_WIDTH = 800;
-constexpr uint16_t EXPECTED_HEIGHT = 480;
+static_assert(Panel::WIDTH == EInkDisplay::DISPLAY_WIDTH && Panel::HEIGHT == EInkDisplay::DISPLAY_HEIGHT &&
+                  Panel::BUFFER_SIZE == EInkDisplay::BUFFER_SIZE,
+              "TRMNL_PANEL does not match the EInkDisplay driver");
+
+// BITMAPFILEHEADER + BITMAPINFOHEADER + 2-entry palette.
+constexpr size_t BMP_HEADER_SIZE = 14 + 40 + 8;
 
 static uint16_t readLe16(const uint8_t* p) {
   return static_cast<uint16_t>(p[0]) | (static_cast<uint16_t>(p[1]) << 8);
@@ -28,34 +39,151 @@ static bool isLight(uint8_t r, uint8_t g, uint8_t b) {
   return y > (255u * 3u / 2u);
 }
 
-}  // namespace
+static void writeLe16(uint8_t* p, const uint16_t v) {
+  p[0] = static_cast<uint8_t>(v);
+  p[1] = static_cast<uint8_t>(v >> 8);
+}
+
+static void writeLe32(uint8_t* p, const uint32_t v) {
+  writeLe16(p, static_cast<uint16_t>(v));
+  writeLe16(p + 2, static_cast<uint16_t>(v >> 16));
+}
+
+// xxHash32 (one shot). Every decoded image is hashed row by row, and this is
+// much cheaper per byte than the ROM's table-driven CRC.
+constexpr uint32_t XXH_PRIME1 = 2654435761u;
+constexpr uint32_t XXH_PRIME2 = 2246822519u;
+constexpr uint32_t XXH_PRIME3 = 3266489917u;
+constexpr uint32_t XXH_PRIME4 = 668265263u;
+constexpr uint32_t XXH_PRIME5 = 374761393u;
+
+inline uint32_t rotl32(const uint32_t x, const int r) {
+  return (x << r) | (x >> (32 - r));
+}
+
+inline uint32_t xxhRound(const uint32_t acc, const uint32_t input) {
+  return rotl32(acc + input * XXH_PRIME2, 13) * XXH_PRIME1;
+}
+
+uint32_t xxh32(const uint8_t* p, const size_t size, const uint32_t seed) {
+  const uint8_t* const end = p + size;
+  uint32_t h;
+  if (size >= 16) {
+    const uint8_t* const limit = end - 16;
+    uint32_t v1 = seed + XXH_PRIME1 + XXH_PRIME2;
+    uint32_t v2 = seed + XXH_PRIME2;
+    uint32_t v3 = seed;
+    uint32_t v4 = seed - XXH_PRIME1;
+    do {
+      v1 = xxhRound(v1, readLe32(p));
+      v2 = xxhRound(v2, readLe32(p + 4));
+      v3 = xxhRound(v3, readLe32(p + 8));
+      v4 = xxhRound(v4, readLe32(p + 12));
+      p += 16;
+    } while (p <= limit);
+    h = rotl32(v1, 1) + rotl32(v2, 7) + rotl32(v3, 12) + rotl32(v4, 18);
+  } else {
+    h = seed + XXH_PRIME5;
+  }
+  h += static_cast<uint32_t>(size);
+
+  for (; p + 4 <= end; p += 4) {
+    h = rotl32(h + readLe32(p) * XXH_PRIME3, 17) * XXH_PRIME4;
+  }
+  for (; p < end; ++p) {
+    h = rotl32(h + *p * XXH_PRIME5, 11) * XXH_PRIME1;
+  }
+
+  h ^= h >> 15;
+  h *= XXH_PRIME2;
+  h ^= h >> 13;
+  h *= XXH_PRIME3;
+  h ^= h >> 16;
+  return h;
+}
+
+// A decoded row's contribution to the frame hash, seeded with its panel row so
+// that the sum does not depend on the order rows were decoded in.
+inline uint32_t rowHash(const uint8_t* row, const uint32_t y) {
+  return xxh32(row, Panel::WIDTH_BYTES, y);
+}
+
+// Row kernels. BMP rows are bottom-up and MSB first; after the palette
+// fix-up 1 = white, which P::fromMsbWhite maps to the panel's byte layout.
+template <class P>
+void blitBmpRow(const uint8_t* src, uint8_t* dst, const bool invert) {
+  const uint8_t flip = invert ? 0xFF : 0x00;
+  for (uint16_t i = 0; i < P::WIDTH_BYTES; ++i) {
+    dst[i] = P::fromMsbWhite(static_cast<uint8_t>(src[i] ^ flip));
+  }
+}
+
+// Raw framebuffers are already in panel layout.
+template <class P>
+void blitRawRow(const uint8_t* src, uint8_t* dst) {
+  memcpy(dst, src, P::WIDTH_BYTES);
+}
+
+// Where the pixel rows sit in a validated image.
+struct Layout {
+  bool framebuffer;      ///< Raw framebuffer (top-down) rather than BMP (bottom-up)
+  uint32_t pixelOffset;
+  uint32_t rowSize;      ///< Bytes per source row, padding included
+  bool invert;           ///< BMP palette has white at index 0
+};
+
+// All checks run before the framebuffer is touched, so a rejected image leaves
+// the previous frame intact.
+BmpResult parseHeader(const uint8_t* data, const size_t size, Layout& layout) {
+  layout = Layout();
+  if (data == nullptr) {
+    return BmpResult::INVALID_SIZE;
+  }
+
+  if (size >= 4 && readLe32(data) == FRAMEBUFFER_MAGIC) {
+    if (size != FRAMEBUFFER_HEADER_SIZE + Panel::BUFFER_SIZE) {
+      return BmpResult::INVALID_SIZE;
+    }
+    if (data[4] != FRAMEBUFFER_VERSION || data[5] != 0) {
+      return BmpResult::UNSUPPORTED_VERSION;
+    }
+    if (readLe16(data + 6) != Panel::WIDTH || readLe16(data + 8) != Panel::HEIGHT) {
+      return BmpResult::INVALID_DIMENSIONS;
+    }
+    if (esp_rom_crc32_le(0, data + FRAMEBUFFER_HEADER_SIZE, Panel::BUFFER_SIZE) != readLe32(data + 12)) {
+      return BmpResult::CHECKSUM_MISMATCH;
+    }
+    layout.framebuffer = true;
+    layout.pixelOffset = FRAMEBUFFER_HEADER_SIZE;
+    layout.rowSize = Panel::WIDTH_BYTES;
+    return BmpResult::SUCCESS;
+  }
 
-BmpResult renderBmp(const uint8_t* bmpData, const size_t size, EInkDisplay& display) {
-  if (bmpData == nullptr || size < 54) {
+  if (size < 54) {
     return BmpResult::INVALID_SIZE;
   }
 
   // BITMAPFILEHEADER (14 bytes)
-  const uint16_t bfType = readLe16(bmpData + 0);
+  const uint16_t bfType = readLe16(data + 0);
   if (bfType != 0x4D42) {  // "BM"
     return BmpResult::INVALID_SIGNATURE;
   }
-  const uint32_t bfOffBits = readLe32(bmpData + 10);
+  const uint32_t bfOffBits = readLe32(data + 10);
   if (bfOffBits >= size) {
     return BmpResult::INVALID_SIZE;
   }
 
   // DIB header (expect BITMAPINFOHEADER = 40)
-  const uint32_t dibSize = readLe32(bmpData + 14);
+  const uint32_t dibSize = readLe32(data + 14);
   if (dibSize != 40) {
     return BmpResult::INVALID_FORMAT;
   }
 
-  const int32_t width = readLe32s(bmpData + 18);
-  const int32_t height = readLe32s(bmpData + 22);
-  const uint16_t planes = readLe16(bmpData + 26);
-  const uint16_t bitCount = readLe16(bmpData + 28);
-  const uint32_t compression = readLe32(bmpData + 30);
+  const int32_t width = readLe32s(data + 18);
+  const int32_t height = readLe32s(data + 22);
+  const uint16_t planes = readLe16(data + 26);
+  const uint16_t bitCount = readLe16(data + 28);
+  const uint32_t compression = readLe32(data + 30);
 
   if (planes != 1) {
     return BmpResult::INVALID_FORMAT;
@@ -66,9 +194,9 @@ BmpResult renderBmp(const uint8_t* bmpData, const size_t size, EInkDisplay& disp
   if (bitCount != 1) {
     return BmpResult::INVALID_BIT_DEPTH;
   }
-  if (width != static_cast<int32_t>(EXPECTED_WIDTH) || (height != static_cast<int32_t>(EXPECTED_HEIGHT))) {
-    // Only bottom-up 800x480 supported for MVP.
-    if (width == static_cast<int32_t>(EXPECTED_WIDTH) && height == -static_cast<int32_t>(EXPECTED_HEIGHT)) {
+  if (width != static_cast<int32_t>(Panel::WIDTH) || (height != static_cast<int32_t>(Panel::HEIGHT))) {
+    // Only bottom-up images at the panel's resolution are supported.
+    if (width == static_cast<int32_t>(Panel::WIDTH) && height == -static_cast<int32_t>(Panel::HEIGHT)) {
       return BmpResult::UNSUPPORTED_ORIENTATION;
     }
     return BmpResult::INVALID_DIMENSIONS;
@@ -76,49 +204,98 @@ BmpResult renderBmp(const uint8_t* bmpData, const size_t size, EInkDisplay& disp
 
   // Palette is 2 entries * 4 bytes, immediately after headers.
   const size_t paletteOffset = 14 + 40;
-  const size_t paletteSize = 8;
-  if (size < paletteOffset + paletteSize) {
+  if (size < BMP_HEADER_SIZE) {
     return BmpResult::INVALID_PALETTE;
   }
-  const uint8_t b0 = bmpData[paletteOffset + 0];
-  const uint8_t g0 = bmpData[paletteOffset + 1];
-  const uint8_t r0 = bmpData[paletteOffset + 2];
-  const uint8_t b1 = bmpData[paletteOffset + 4];
-  const uint8_t g1 = bmpData[paletteOffset + 5];
-  const uint8_t r1 = bmpData[paletteOffset + 6];
+  const uint8_t b0 = data[paletteOffset + 0];
+  const uint8_t g0 = data[paletteOffset + 1];
+  const uint8_t r0 = data[paletteOffset + 2];
+  const uint8_t b1 = data[paletteOffset + 4];
+  const uint8_t g1 = data[paletteOffset + 5];
+  const uint8_t r1 = data[paletteOffset + 6];
 
   // If palette[0] is lighter than palette[1], BMP's 0 bits represent white; invert so 1=white in framebuffer.
-  const bool needsInversion = isLight(r0, g0, b0) && !isLight(r1, g1, b1);
+  layout.invert = isLight(r0, g0, b0) && !isLight(r1, g1, b1);
 
-  const uint32_t rowSize = ((EXPECTED_WIDTH + 31u) / 32u) * 4u;
-  const uint32_t pixelBytesNeeded = rowSize * EXPECTED_HEIGHT;
+  constexpr uint32_t rowSize = ((Panel::WIDTH + 31u) / 32u) * 4u;
+  constexpr uint32_t pixelBytesNeeded = rowSize * Panel::HEIGHT;
   if (bfOffBits + pixelBytesNeeded > size) {
     return BmpResult::INVALID_SIZE;
   }
 
-  uint8_t* framebuffer = display.getFrameBuffer();
-  if (!framebuffer) {
-    return BmpResult::BUFFER_OVERFLOW;
-  }
+  layout.pixelOffset = bfOffBits;
+  layout.rowSize = rowSize;
+  return BmpResult::SUCCESS;
+}
+
+}  // namespace
 
-  const uint8_t* pixelData = bmpData + bfOffBits;
+void makeFramebufferHeader(const uint8_t* pixels, uint8_t (&header)[FRAMEBUFFER_HEADER_SIZE]) {
+  memset(header, 0, sizeof(header));
+  writeLe32(header + 0, FRAMEBUFFER_MAGIC);
+  header[4] = FRAMEBUFFER_VERSION;
+  writeLe16(header + 6, Panel::WIDTH);
+  writeLe16(header + 8, Panel::HEIGHT);
+  writeLe32(header + 12, esp_rom_crc32_le(0, pixels, Panel::BUFFER_SIZE));
+}
+
+uint32_t frameHash(const uint8_t* framebuffer) {
+  uint32_t hash = 0;
+  for (uint32_t y = 0; y < Panel::HEIGHT; ++y) {
+    hash += rowHash(framebuffer + y * Panel::WIDTH_BYTES, y);
+  }
+  return hash;
+}
 
-  for (uint32_t srcRow = 0; srcRow < EXPECTED_HEIGHT; ++srcRow) {
-    const uint32_t dstRow = (EXPECTED_HEIGHT - 1u) - srcRow;
-    const uint8_t* src = pixelData + (srcRow * rowSize);
-    uint8_t* dst = framebuffer + (dstRow * EInkDisplay::DISPLAY_WIDTH_BYTES);
+BmpResult decode(const uint8_t* data, const size_t size, EInkDisplay& display, uint32_t* hash) {
+  Layout layout;
+  BmpResult result = parseHeader(data, size, layout);
+  uint8_t* framebuffer = display.getFrameBuffer();
+  if (result == BmpResult::SUCCESS && !framebuffer) {
+    result = BmpResult::BUFFER_OVERFLOW;
+  }
+  if (result != BmpResult::SUCCESS) {
+    Telemetry::record(Telemetry::Event::IMAGE_RENDER, static_cast<int32_t>(result));
+    return result;
+  }
 
-    for (uint32_t i = 0; i < EInkDisplay::DISPLAY_WIDTH_BYTES; ++i) {
-      uint8_t v = src[i];
-      if (needsInversion) {
-        v = static_cast<uint8_t>(~v);
-      }
-      dst[i] = v;
+  uint32_t frame = 0;
+  for (uint32_t row = 0; row < Panel::HEIGHT; ++row) {
+    const uint8_t* src = data + layout.pixelOffset + row * layout.rowSize;
+    // BMP rows are stored bottom-up.
+    const uint32_t dstRow = layout.framebuffer ? row : (Panel::HEIGHT - 1u) - row;
+    uint8_t* dst = framebuffer + dstRow * Panel::WIDTH_BYTES;
+    if (layout.framebuffer) {
+      blitRawRow<Panel>(src, dst);
+    } else {
+      blitBmpRow<Panel>(src, dst, layout.invert);
     }
+    frame += rowHash(dst, dstRow);
   }
+  if (hash != nullptr) {
+    *hash = frame;
+  }
+  return BmpResult::SUCCESS;
+}
 
-  display.displayBuffer(EInkDisplay::FAST_REFRESH, false);
+BmpResult showDecoded(EInkDisplay& display, const uint32_t decodeStartMs) {
+  const uint32_t refreshStart = millis();
+  {
+    EnergyMeter::Scope busy(EnergyMeter::State::DISPLAY);
+    display.displayBuffer(EInkDisplay::FAST_REFRESH, false);
+  }
+  Telemetry::record(Telemetry::Event::IMAGE_RENDER, static_cast<int32_t>(BmpResult::SUCCESS),
+                    static_cast<int32_t>(refreshStart - decodeStartMs), static_cast<int32_t>(millis() - refreshStart));
   return BmpResult::SUCCESS;
 }
 
+BmpResult render(const uint8_t* data, const size_t size, EInkDisplay& display) {
+  const uint32_t decodeStart = millis();
+  const BmpResult result = decode(data, size, display);
+  if (result != BmpResult::SUCCESS) {
+    return result;
+  }
+  return showDecoded(display, decodeStart);
+}
+
 }  // namespace ImageRenderer
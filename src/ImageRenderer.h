@@ -4,6 +4,8 @@
 #include <stdint.h>
 #include <EInkDisplay.h>
 
+#include "PanelGeometry.h"
+
 namespace ImageRenderer {
 
 /**
@@ -18,24 +20,83 @@ enum class BmpResult {
   INVALID_BIT_DEPTH,
   UNSUPPORTED_ORIENTATION,
   INVALID_PALETTE,
-  BUFFER_OVERFLOW
+  BUFFER_OVERFLOW,
+  UNSUPPORTED_VERSION,
+  CHECKSUM_MISMATCH
 };
 
 /**
- * Render a 1-bit monochrome BMP image to the EInk display.
+ * Raw framebuffer format ("TRFB"), requested from the server with
+ * FRAMEBUFFER_CONTENT_TYPE in the image request's Accept header.
+ *
+ * Layout: a 16-byte little-endian header followed by exactly
+ * Panel::BUFFER_SIZE bytes in the panel's own layout (top-down rows, no row
+ * padding; on the X4 MSB = leftmost pixel and 1 = white).
+ *
+ *   0  uint32 magic    "TRFB"
+ *   4  uint8  version  FRAMEBUFFER_VERSION
+ *   5  uint8  flags    0
+ *   6  uint16 width    Panel::WIDTH (800 on the X4)
+ *   8  uint16 height   Panel::HEIGHT (480 on the X4)
+ *  10  uint16 reserved 0
+ *  12  uint32 crc32    CRC-32 (zlib) of the pixel bytes
+ */
+constexpr const char* FRAMEBUFFER_CONTENT_TYPE = "application/x-trmnl-framebuffer";
+constexpr uint32_t FRAMEBUFFER_MAGIC = 0x42465254;  // "TRFB"
+constexpr uint8_t FRAMEBUFFER_VERSION = 1;
+constexpr size_t FRAMEBUFFER_HEADER_SIZE = 16;
+
+/**
+ * Fill in the raw framebuffer header for Panel::BUFFER_SIZE bytes of pixels.
+ */
+void makeFramebufferHeader(const uint8_t* pixels, uint8_t (&header)[FRAMEBUFFER_HEADER_SIZE]);
+
+/**
+ * Content hash of a framebuffer: the sum of each row's xxHash32, seeded with
+ * the row index. Identical pixels give the same hash whatever format or
+ * image URL they came in, which lets the caller skip refreshing the panel
+ * with the frame it already shows.
+ */
+uint32_t frameHash(const uint8_t* framebuffer);
+
+/**
+ * Decode a complete image in memory into the display framebuffer, without
+ * refreshing the panel. Every header check (and the raw framebuffer's CRC-32)
+ * passes before the framebuffer is written, so a rejected image leaves the
+ * previous frame in place.
  *
- * Supports:
- * - 800x480 resolution only
+ * BMP support:
+ * - The panel's resolution only (800x480 on the X4)
  * - 1-bit monochrome (black/white) BMPs
  * - Bottom-up orientation (standard BMP storage)
  * - Proper BMP row padding (4-byte boundary)
  * - Automatic palette inversion detection
  *
- * @param bmpData Pointer to BMP data buffer
- * @param size Size of BMP data in bytes
+ * @param data Pointer to BMP or raw framebuffer data
+ * @param size Size of data in bytes
+ * @param display Reference to EInkDisplay instance
+ * @param hash Optional output: frameHash() of the decoded image
+ * @return BmpResult Result code indicating success or failure reason
+ */
+BmpResult decode(const uint8_t* data, size_t size, EInkDisplay& display, uint32_t* hash = nullptr);
+
+/**
+ * Refresh the display with an image decode() put in the framebuffer.
+ *
+ * @param display Reference to EInkDisplay instance
+ * @param decodeStartMs millis() when decoding started, for telemetry
+ * @return BmpResult::SUCCESS
+ */
+BmpResult showDecoded(EInkDisplay& display, uint32_t decodeStartMs);
+
+/**
+ * Decode a complete image in memory and refresh the EInk display.
+ *
+ * @param data Pointer to BMP or raw framebuffer data
+ * @param size Size of data in bytes
  * @param display Reference to EInkDisplay instance
  * @return BmpResult Result code indicating success or failure reason
  */
-BmpResult renderBmp(const uint8_t* bmpData, size_t size, EInkDisplay& display);
+BmpResult render(const uint8_t* data, size_t size, EInkDisplay& display);
 
 }  // namespace ImageRenderer
@@ -0,0 +1,160 @@
+#include "InputEvents.h"
+
+#include <InputManager.h>
+#include <driver/gpio.h>
+#include <esp_sleep.h>
+#include <freertos/FreeRTOS.h>
+#include <hal/gpio_ll.h>
+
+#include <algorithm>
+
+#include "EnergyMeter.h"
+#include "WifiConnector.h"
+
+namespace {
+
+constexpr gpio_num_t POWER_GPIO = static_cast<gpio_num_t>(InputEvents::POWER_PIN);
+
+portMUX_TYPE edgeMux = portMUX_INITIALIZER_UNLOCKED;
+volatile uint32_t lastEdgeMs = 0;
+volatile uint32_t latchedPressMs = 0;
+volatile bool pressLatched = false;
+bool attached = false;
+
+bool lastWasPower = false;
+uint32_t lastPressMs = 0;
+
+// Caller holds edgeMux. The first edge after a quiet DEBOUNCE_MS wins; contact
+// bounce behind it is ignored.
+void IRAM_ATTR noteEdge(const bool low, const uint32_t now) {
+    if (now - lastEdgeMs < InputEvents::DEBOUNCE_MS) {
+        return;
+    }
+    lastEdgeMs = now;
+    if (low) {
+        latchedPressMs = now;
+        pressLatched = true;
+    }
+}
+
+// The GPIO ISR service may have been installed IRAM-only by the core, so
+// read the pin through the inline HAL rather than gpio_get_level().
+void IRAM_ATTR onPowerEdge(void*) {
+    portENTER_CRITICAL_ISR(&edgeMux);
+    noteEdge(gpio_ll_get_level(&GPIO, POWER_GPIO) == 0, millis());
+    portEXIT_CRITICAL_ISR(&edgeMux);
+}
+
+bool takeLatch(uint32_t& pressMs) {
+    portENTER_CRITICAL(&edgeMux);
+    const bool latched = pressLatched;
+    pressMs = latchedPressMs;
+    pressLatched = false;
+    portEXIT_CRITICAL(&edgeMux);
+    return latched;
+}
+
+// Light sleep powers down the USB PHY and misses beacons, so only use it with
+// the radio off and no USB host listening.
+bool canLightSleep() {
+    return !WifiConnector::isStarted() && !Serial;
+}
+
+void lightSleep(const uint32_t ms, const bool watchPower) {
+    EnergyMeter::Scope asleep(EnergyMeter::State::LIGHT_SLEEP);
+    esp_sleep_enable_timer_wakeup(static_cast<uint64_t>(ms) * 1000ULL);
+
+    // GPIO wake is level-triggered: wait for the opposite of the current
+    // level, so a held button does not wake us straight away. It reuses the
+    // pin's interrupt type, which is put back afterwards.
+    bool wasLow = false;
+    if (watchPower && attached) {
+        gpio_intr_disable(POWER_GPIO);
+        wasLow = gpio_get_level(POWER_GPIO) == 0;
+        gpio_wakeup_enable(POWER_GPIO, wasLow ? GPIO_INTR_HIGH_LEVEL : GPIO_INTR_LOW_LEVEL);
+        esp_sleep_enable_gpio_wakeup();
+    }
+
+    esp_light_sleep_start();
+
+    if (watchPower && attached) {
+        const bool byButton = esp_sleep_get_wakeup_cause() == ESP_SLEEP_WAKEUP_GPIO;
+        esp_sleep_disable_wakeup_source(ESP_SLEEP_WAKEUP_GPIO);
+        gpio_wakeup_disable(POWER_GPIO);
+        gpio_set_intr_type(POWER_GPIO, GPIO_INTR_ANYEDGE);
+        if (byButton) {
+            // The edge happened while the ISR could not run.
+            portENTER_CRITICAL(&edgeMux);
+            noteEdge(!wasLow, millis());
+            portEXIT_CRITICAL(&edgeMux);
+        }
+        gpio_intr_enable(POWER_GPIO);
+    }
+    esp_sleep_disable_wakeup_source(ESP_SLEEP_WAKEUP_TIMER);
+}
+
+void pause(const uint32_t ms, const bool watchPower) {
+    if (canLightSleep()) {
+        lightSleep(ms, watchPower);
+    } else {
+        delay(ms);
+    }
+}
+
+}  // namespace
+
+void InputEvents::begin() {
+    if (attached) {
+        return;
+    }
+    // The Arduino core may already own the ISR service.
+    const esp_err_t err = gpio_install_isr_service(0);
+    if (err != ESP_OK && err != ESP_ERR_INVALID_STATE) {
+        return;
+    }
+    gpio_set_intr_type(POWER_GPIO, GPIO_INTR_ANYEDGE);
+    if (gpio_isr_handler_add(POWER_GPIO, onPowerEdge, nullptr) != ESP_OK) {
+        return;
+    }
+    gpio_intr_enable(POWER_GPIO);
+    attached = true;
+}
+
+bool InputEvents::waitForPress(InputManager& input, const uint32_t timeoutMs) {
+    const uint32_t start = millis();
+    for (;;) {
+        input.update();
+
+        // The power button is reported from the interrupt only; InputManager
+        // may see the same press one sample later.
+        uint32_t edgeMs = 0;
+        if (takeLatch(edgeMs)) {
+            lastWasPower = true;
+            lastPressMs = edgeMs;
+            return true;
+        }
+        if (input.wasAnyPressed()) {
+            lastWasPower = false;
+            lastPressMs = millis();
+            return true;
+        }
+
+        const uint32_t elapsed = millis() - start;
+        if (elapsed >= timeoutMs) {
+            return false;
+        }
+        pause(std::min(POLL_MS, timeoutMs - elapsed), true);
+    }
+}
+
+bool InputEvents::powerPressed() {
+    return lastWasPower;
+}
+
+uint32_t InputEvents::pressMs() {
+    return lastPressMs;
+}
+
+void InputEvents::idle(const uint32_t ms) {
+    pause(ms, false);
+}
@@ -0,0 +1,60 @@
+#pragma once
+
+#include <Arduino.h>
+
+class InputManager;
+
+/**
+ * @brief Event-driven waits for the buttons, with light sleep in between
+ *
+ * The power button is a plain GPIO, so an edge interrupt timestamps and
+ * debounces it, and it can wake the chip from light sleep directly. The other
+ * buttons share an ADC ladder that cannot raise interrupts, so they are sampled
+ * through InputManager after each light-sleep slice of at most POLL_MS. That
+ * keeps button-to-handler latency under POLL_MS + InputManager's own debounce.
+ *
+ * Light sleep stops the CPU clock but would drop an association in progress
+ * and the USB serial console. Waits therefore fall back to delay() while the
+ * radio is on or a USB host is attached.
+ */
+class InputEvents {
+public:
+    static constexpr uint8_t POWER_PIN = 3;
+    static constexpr uint32_t POLL_MS = 20;
+    static constexpr uint32_t DEBOUNCE_MS = 30;
+
+    /**
+     * @brief Attach the power-button interrupt (call after InputManager::begin())
+     */
+    static void begin();
+
+    /**
+     * @brief Sleep until a button is pressed or timeoutMs passes
+     *
+     * InputManager::update() has run when this returns, so callers check
+     * wasPressed() as before.
+     *
+     * @return true if any button was pressed
+     */
+    static bool waitForPress(InputManager& input, uint32_t timeoutMs);
+
+    /**
+     * @brief Idle for ms without watching the buttons (USB window, uptime padding)
+     */
+    static void idle(uint32_t ms);
+
+    /**
+     * @brief Whether the last waitForPress() ended on a power-button press
+     *
+     * Taken from the debounced interrupt, so a tap shorter than one sample
+     * period still counts. Check InputManager for the other buttons.
+     */
+    static bool powerPressed();
+
+    /**
+     * @brief millis() of the press that ended the last waitForPress()
+     *
+     * Exact for the power button, up to POLL_MS late for the ladder buttons.
+     */
+    static uint32_t pressMs();
+};
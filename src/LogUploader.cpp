@@ -0,0 +1,170 @@
+#include "LogUploader.h"
+
+#include <HTTPClient.h>
+#include <WiFiClient.h>
+
+#include <stdio.h>
+#include <string.h>
+
+#include "WallClock.h"
+
+namespace {
+
+constexpr uint32_t RTC_MAGIC = 0x4C4F4751;  // "LOGQ"
+
+struct LogEntry {
+    uint32_t epoch;
+    uint32_t id;
+    int32_t code;
+    char message[LogUploader::MESSAGE_MAX];
+};
+
+struct RtcLogQueue {
+    uint32_t magic;
+    uint16_t head;  ///< Next slot to write
+    uint16_t count;
+    uint32_t dropped;
+    uint32_t nextId;
+    LogEntry entries[LogUploader::QUEUE_SIZE];
+};
+
+RTC_DATA_ATTR RtcLogQueue rtcQueue;
+
+char body[LogUploader::BYTE_BUDGET];
+
+void ensureQueue() {
+    if (rtcQueue.magic != RTC_MAGIC || rtcQueue.head >= LogUploader::QUEUE_SIZE ||
+        rtcQueue.count > LogUploader::QUEUE_SIZE) {
+        memset(&rtcQueue, 0, sizeof(rtcQueue));
+        rtcQueue.magic = RTC_MAGIC;
+        rtcQueue.nextId = 1;
+    }
+}
+
+const LogEntry& entryAt(const size_t i) {
+    const size_t tail = (rtcQueue.head + LogUploader::QUEUE_SIZE - rtcQueue.count) % LogUploader::QUEUE_SIZE;
+    return rtcQueue.entries[(tail + i) % LogUploader::QUEUE_SIZE];
+}
+
+// Appends a JSON string literal. Returns the new length, or 0 if it didn't fit.
+size_t appendEscaped(char* out, size_t len, const size_t cap, const char* text) {
+    if (len + 1 >= cap) {
+        return 0;
+    }
+    out[len++] = '"';
+    for (const char* p = text; *p != '\0'; ++p) {
+        const char c = *p;
+        if (c == '"' || c == '\\') {
+            if (len + 2 >= cap) {
+                return 0;
+            }
+            out[len++] = '\\';
+            out[len++] = c;
+        } else if (static_cast<unsigned char>(c) >= 0x20) {
+            if (len + 1 >= cap) {
+                return 0;
+            }
+            out[len++] = c;
+        }
+    }
+    if (len + 1 >= cap) {
+        return 0;
+    }
+    out[len++] = '"';
+    out[len] = '\0';
+    return len;
+}
+
+// Serializes as many queued entries as fit in the byte budget.
+size_t buildBody(size_t& bodyLen) {
+    const char* const suffix = "]}}";
+    const size_t suffixLen = strlen(suffix);
+    const size_t cap = sizeof(body) - suffixLen;
+
+    int n = snprintf(body, cap, "{\"dropped_entries\":%u,\"log\":{\"logs_array\":[",
+                     static_cast<unsigned>(rtcQueue.dropped));
+    size_t len = static_cast<size_t>(n);
+
+    size_t packed = 0;
+    for (; packed < rtcQueue.count; ++packed) {
+        const LogEntry& entry = entryAt(packed);
+        const size_t entryStart = len;
+
+        n = snprintf(body + len, cap - len, "%s{\"log_id\":%u,\"creation_timestamp\":%u,\"log_codeline\":%d,\"log_message\":",
+                     packed ? "," : "", static_cast<unsigned>(entry.id), static_cast<unsigned>(entry.epoch),
+                     static_cast<int>(entry.code));
+        if (n < 0 || len + static_cast<size_t>(n) >= cap) {
+            len = entryStart;
+            break;
+        }
+        len += static_cast<size_t>(n);
+
+        len = appendEscaped(body, len, cap, entry.message);
+        if (len == 0 || len + 1 >= cap) {
+            len = entryStart;
+            break;
+        }
+        body[len++] = '}';
+    }
+
+    memcpy(body + len, suffix, suffixLen + 1);
+    bodyLen = len + suffixLen;
+    return packed;
+}
+
+}  // namespace
+
+void LogUploader::enqueue(const int32_t code, const char* message) {
+    ensureQueue();
+
+    LogEntry& entry = rtcQueue.entries[rtcQueue.head];
+    entry.epoch = static_cast<uint32_t>(WallClock::now());
+    entry.id = rtcQueue.nextId++;
+    entry.code = code;
+    strlcpy(entry.message, message ? message : "", sizeof(entry.message));
+
+    rtcQueue.head = static_cast<uint16_t>((rtcQueue.head + 1) % QUEUE_SIZE);
+    if (rtcQueue.count < QUEUE_SIZE) {
+        rtcQueue.count++;
+    } else {
+        rtcQueue.dropped++;
+    }
+}
+
+size_t LogUploader::pending() {
+    ensureQueue();
+    return rtcQueue.count;
+}
+
+size_t LogUploader::upload(HTTPClient& http, WiFiClient& client, const String& logUrl, const TrmnlConfig& config) {
+    ensureQueue();
+    if (rtcQueue.count == 0) {
+        return 0;
+    }
+
+    size_t bodyLen = 0;
+    const size_t packed = buildBody(bodyLen);
+    if (packed == 0) {
+        return 0;
+    }
+
+    // The display request was ended with reuse enabled, so begin() picks up
+    // the same socket as long as the server kept it alive.
+    if (!http.begin(client, logUrl)) {
+        return 0;
+    }
+    http.addHeader("ID", config.deviceId);
+    http.addHeader("Access-Token", config.apiKey);
+    http.addHeader("Content-Type", "application/json");
+
+    const int httpCode = http.POST(reinterpret_cast<uint8_t*>(body), bodyLen);
+    http.end();
+
+    if (httpCode < 200 || httpCode >= 300) {
+        return 0;
+    }
+
+    rtcQueue.count = static_cast<uint16_t>(rtcQueue.count - packed);
+    rtcQueue.dropped = 0;
+    return packed;
+}
@@ -0,0 +1,52 @@
+#pragma once
+
+#include <Arduino.h>
+
+#include "ConfigLoader.h"
+
+class HTTPClient;
+class WiFiClient;
+
+/**
+ * @brief Queued device log upload to TRMNL's /api/log endpoint
+ *
+ * Entries are queued in RTC memory so they survive deep sleep, including
+ * wakes that failed before reaching the server. The queue is sent as one
+ * batched POST over the same (kept-alive) connection right after a
+ * successful /api/display call, so uploading never costs an extra wake or TLS
+ * handshake. Each wake sends at most BYTE_BUDGET bytes of JSON. When the
+ * queue is full, the oldest entry is dropped.
+ */
+class LogUploader {
+public:
+    static constexpr size_t QUEUE_SIZE = 12;
+    static constexpr size_t MESSAGE_MAX = 52;     ///< Including terminator
+    static constexpr size_t BYTE_BUDGET = 1536;   ///< Max POST body per wake
+
+    /**
+     * @brief Queue a log entry for the next successful /api/display call
+     *
+     * @param code Numeric code (ApiError, wl_status_t, ...) sent as log_codeline
+     * @param message Short message, truncated to MESSAGE_MAX - 1 characters
+     */
+    static void enqueue(int32_t code, const char* message);
+
+    /**
+     * @brief Number of entries waiting to be sent
+     */
+    static size_t pending();
+
+    /**
+     * @brief POST queued entries on an already-open connection
+     *
+     * Called by ApiClient after the /api/display response has been consumed.
+     * Entries are removed from the queue only after a 2xx response.
+     *
+     * @param http HTTPClient used for /api/display (ended, connection kept alive)
+     * @param client The client socket the display request used
+     * @param logUrl Full URL of the /api/log endpoint
+     * @param config TrmnlConfig for credentials
+     * @return Number of entries delivered
+     */
+    static size_t upload(HTTPClient& http, WiFiClient& client, const String& logUrl, const TrmnlConfig& config);
+};
@@ -0,0 +1,152 @@
+#include "OtaUpdater.h"
+
+#include <HTTPClient.h>
+#include <esp_ota_ops.h>
+#include <mbedtls/sha256.h>
+
+#include <algorithm>
+
+#include "BulkReader.h"
+#include "CachedDnsClient.h"
+#include "EnergyMeter.h"
+#include "Telemetry.h"
+
+namespace {
+
+uint8_t chunk[OtaUpdater::CHUNK_SIZE];
+
+bool parseSha256Hex(const char* hex, uint8_t out[32]) {
+    if (strlen(hex) != 64) {
+        return false;
+    }
+    for (size_t i = 0; i < 32; ++i) {
+        char byteHex[3] = {hex[2 * i], hex[2 * i + 1], '\0'};
+        char* end = nullptr;
+        out[i] = static_cast<uint8_t>(strtoul(byteHex, &end, 16));
+        if (end != byteHex + 2) {
+            return false;
+        }
+    }
+    return true;
+}
+
+OtaResult finish(const OtaResult result, const size_t bytes, const uint32_t startMs) {
+    Telemetry::record(Telemetry::Event::OTA, static_cast<int32_t>(result), static_cast<int32_t>(bytes),
+                      static_cast<int32_t>(millis() - startMs));
+    return result;
+}
+
+}  // namespace
+
+OtaResult OtaUpdater::update(const FirmwareUpdate& firmware, const TrmnlConfig& config) {
+    const uint32_t startMs = millis();
+
+    if (!config.standaloneMode) {
+        return finish(OtaResult::SKIPPED_APP_MODE, 0, startMs);
+    }
+
+    uint8_t expected[32];
+    if (!parseSha256Hex(firmware.sha256, expected)) {
+        return finish(OtaResult::MISSING_CHECKSUM, 0, startMs);
+    }
+
+    const esp_partition_t* running = esp_ota_get_running_partition();
+    const esp_partition_t* target = esp_ota_get_next_update_partition(nullptr);
+    if (running == nullptr || target == nullptr || target->address == running->address) {
+        return finish(OtaResult::NO_PARTITION, 0, startMs);
+    }
+
+    // Same DNS cache as the API and image requests; the firmware host is often the same.
+    CachedDnsClient client(config.dnsCacheTtlSeconds);
+    if (config.useInsecureTls) {
+        client.setInsecure();
+    }
+
+    HTTPClient http;
+    http.setTimeout(INACTIVITY_TIMEOUT_MS);
+    if (!http.begin(client, firmware.url)) {
+        return finish(OtaResult::HTTP_FAILED, 0, startMs);
+    }
+
+    EnergyMeter::Scope transfer(EnergyMeter::State::TRANSFER);
+    const int httpCode = http.GET();
+    if (httpCode != HTTP_CODE_OK) {
+        http.end();
+        return finish(OtaResult::HTTP_FAILED, 0, startMs);
+    }
+
+    const int contentLength = http.getSize();
+    if (contentLength <= 0 || static_cast<uint32_t>(contentLength) > target->size) {
+        http.end();
+        return finish(OtaResult::IMAGE_TOO_LARGE, 0, startMs);
+    }
+
+    esp_ota_handle_t ota = 0;
+    if (esp_ota_begin(target, static_cast<size_t>(contentLength), &ota) != ESP_OK) {
+        http.end();
+        return finish(OtaResult::WRITE_FAILED, 0, startMs);
+    }
+
+    mbedtls_sha256_context sha;
+    mbedtls_sha256_init(&sha);
+    mbedtls_sha256_starts_ret(&sha, 0);
+
+    BulkReader reader(client, INACTIVITY_TIMEOUT_MS);
+    size_t written = 0;
+    OtaResult result = OtaResult::SUCCESS;
+
+    while (written < static_cast<size_t>(contentLength)) {
+        const size_t toRead = std::min(sizeof(chunk), static_cast<size_t>(contentLength) - written);
+        const size_t r = reader.read(chunk, toRead);
+        if (r == 0) {
+            result = OtaResult::TIMEOUT;
+            break;
+        }
+
+        mbedtls_sha256_update_ret(&sha, chunk, r);
+        if (esp_ota_write(ota, chunk, r) != ESP_OK) {
+            result = OtaResult::WRITE_FAILED;
+            break;
+        }
+        written += r;
+    }
+    http.end();
+
+    uint8_t digest[32];
+    mbedtls_sha256_finish_ret(&sha, digest);
+    mbedtls_sha256_free(&sha);
+
+    if (result != OtaResult::SUCCESS) {
+        esp_ota_abort(ota);
+        return finish(result, written, startMs);
+    }
+    if (memcmp(digest, expected, sizeof(digest)) != 0) {
+        esp_ota_abort(ota);
+        return finish(OtaResult::CHECKSUM_MISMATCH, written, startMs);
+    }
+    // esp_ota_end() also validates the app image header and checksum.
+    if (esp_ota_end(ota) != ESP_OK) {
+        return finish(OtaResult::IMAGE_INVALID, written, startMs);
+    }
+    if (esp_ota_set_boot_partition(target) != ESP_OK) {
+        return finish(OtaResult::WRITE_FAILED, written, startMs);
+    }
+
+    return finish(OtaResult::SUCCESS, written, startMs);
+}
+
+const char* OtaUpdater::resultToString(const OtaResult result) {
+    switch (result) {
+        case OtaResult::SUCCESS: return "success";
+        case OtaResult::SKIPPED_APP_MODE: return "skipped (CrossPoint app mode)";
+        case OtaResult::MISSING_CHECKSUM: return "missing or malformed firmware_sha256";
+        case OtaResult::NO_PARTITION: return "no inactive OTA partition";
+        case OtaResult::HTTP_FAILED: return "download failed";
+        case OtaResult::IMAGE_TOO_LARGE: return "image larger than partition";
+        case OtaResult::WRITE_FAILED: return "flash write failed";
+        case OtaResult::TIMEOUT: return "download stalled";
+        case OtaResult::CHECKSUM_MISMATCH: return "SHA-256 mismatch";
+        case OtaResult::IMAGE_INVALID: return "image rejected";
+    }
+    return "unknown";
+}
@@ -0,0 +1,51 @@
+#pragma once
+
+#include <Arduino.h>
+
+#include "ApiClient.h"
+#include "ConfigLoader.h"
+
+/**
+ * @brief Result codes for firmware updates
+ */
+enum class OtaResult {
+    SUCCESS = 0,
+    SKIPPED_APP_MODE,    ///< Running as a CrossPoint app; the other slot is CrossPoint
+    MISSING_CHECKSUM,    ///< Server did not send firmware_sha256
+    NO_PARTITION,        ///< No inactive OTA slot
+    HTTP_FAILED,
+    IMAGE_TOO_LARGE,
+    WRITE_FAILED,
+    TIMEOUT,
+    CHECKSUM_MISMATCH,
+    IMAGE_INVALID        ///< esp_ota_end() rejected the image
+};
+
+/**
+ * @brief Streaming OTA firmware updater
+ *
+ * Streams the image from the HTTP socket into the inactive OTA partition in
+ * CHUNK_SIZE pieces and hashes each chunk with SHA-256 as it is written. The
+ * image is never held in RAM. Reads go through BulkReader, which blocks in
+ * select() between TLS records, and the host is resolved through DnsCache. The new slot is only marked bootable if the
+ * digest matches firmware_sha256 and esp_ota_end() accepts the image.
+ *
+ * CrossPoint layout: as a CrossPoint app this firmware runs in ota_1, and the
+ * "next" slot (ota_0) is CrossPoint itself, which returnToCrossPoint() boots
+ * into. Updates are therefore only applied in standalone_mode. App installs
+ * are updated through CrossPoint's app loader instead.
+ */
+class OtaUpdater {
+public:
+    /**
+     * @brief Download, verify and activate a firmware image
+     *
+     * On SUCCESS the boot partition has been switched; the caller restarts.
+     */
+    static OtaResult update(const FirmwareUpdate& firmware, const TrmnlConfig& config);
+
+    static const char* resultToString(OtaResult result);
+
+    static constexpr size_t CHUNK_SIZE = 4096;
+    static constexpr uint32_t INACTIVITY_TIMEOUT_MS = 15000;
+};
@@ -0,0 +1,101 @@
+#pragma once
+
+#include <stddef.h>
+#include <stdint.h>
+
+/**
+ * @brief Compile-time description of the e-paper panel's framebuffer
+ *
+ * The pixel kernels (image row blit, text, status strip) are templates over
+ * a PanelGeometry, instantiated once with the board's Panel. Width, stride,
+ * bit order and polarity are therefore constants in every loop, and a build
+ * for another SSD16xx size needs no runtime geometry checks.
+ *
+ * The board is chosen with -DTRMNL_PANEL=<name in Boards> in platformio.ini
+ * (default X4). The SDK's EInkDisplay owns the framebuffer, so ImageRenderer
+ * static_asserts that its geometry matches Panel.
+ */
+namespace PanelGeometry {
+
+enum class BitOrder : uint8_t {
+    MSB_FIRST,  ///< Bit 7 of each byte is the leftmost pixel
+    LSB_FIRST   ///< Bit 0 of each byte is the leftmost pixel
+};
+
+enum class Polarity : uint8_t {
+    ONE_IS_WHITE,  ///< SSD16xx black/white RAM
+    ONE_IS_BLACK
+};
+
+constexpr uint8_t reverseBits(const uint8_t b) {
+    return static_cast<uint8_t>(((b & 0x01) << 7) | ((b & 0x02) << 5) | ((b & 0x04) << 3) | ((b & 0x08) << 1) |
+                                ((b & 0x10) >> 1) | ((b & 0x20) >> 3) | ((b & 0x40) >> 5) | ((b & 0x80) >> 7));
+}
+
+template <uint16_t W, uint16_t H, BitOrder ORDER, Polarity POLARITY>
+struct Geometry {
+    static_assert(W % 8 == 0, "Rows must be whole bytes");
+
+    static constexpr uint16_t WIDTH = W;
+    static constexpr uint16_t HEIGHT = H;
+    static constexpr uint16_t WIDTH_BYTES = W / 8;
+    static constexpr uint32_t BUFFER_SIZE = static_cast<uint32_t>(WIDTH_BYTES) * H;
+    static constexpr uint8_t WHITE_BYTE = POLARITY == Polarity::ONE_IS_WHITE ? 0xFF : 0x00;
+    static constexpr uint8_t BLACK_BYTE = static_cast<uint8_t>(~WHITE_BYTE);
+
+    /// Bit of pixel x within its framebuffer byte
+    static constexpr uint8_t mask(const uint16_t x) {
+        return ORDER == BitOrder::MSB_FIRST ? static_cast<uint8_t>(0x80u >> (x & 7u))
+                                            : static_cast<uint8_t>(1u << (x & 7u));
+    }
+
+    /// Framebuffer byte for 8 pixels given MSB-first with 1 = white (BMP after palette fix-up)
+    static constexpr uint8_t fromMsbWhite(const uint8_t b) {
+        return ORDER == BitOrder::MSB_FIRST
+                   ? (POLARITY == Polarity::ONE_IS_WHITE ? b : static_cast<uint8_t>(~b))
+                   : (POLARITY == Polarity::ONE_IS_WHITE ? reverseBits(b) : reverseBits(static_cast<uint8_t>(~b)));
+    }
+
+    /// Framebuffer byte for 8 pixels given MSB-first with 1 = ink (font rows)
+    static constexpr uint8_t fromMsbInk(const uint8_t b) {
+        return fromMsbWhite(static_cast<uint8_t>(~b));
+    }
+
+    /// Paint pixel x of a framebuffer row black
+    static void ink(uint8_t* row, const uint16_t x) {
+        if (POLARITY == Polarity::ONE_IS_WHITE) {
+            row[x / 8] &= static_cast<uint8_t>(~mask(x));
+        } else {
+            row[x / 8] |= mask(x);
+        }
+    }
+};
+
+// Out-of-line definitions for C++11 ODR-uses (e.g. binding to std::min).
+template <uint16_t W, uint16_t H, BitOrder O, Polarity P>
+constexpr uint16_t Geometry<W, H, O, P>::WIDTH;
+template <uint16_t W, uint16_t H, BitOrder O, Polarity P>
+constexpr uint16_t Geometry<W, H, O, P>::HEIGHT;
+template <uint16_t W, uint16_t H, BitOrder O, Polarity P>
+constexpr uint16_t Geometry<W, H, O, P>::WIDTH_BYTES;
+template <uint16_t W, uint16_t H, BitOrder O, Polarity P>
+constexpr uint32_t Geometry<W, H, O, P>::BUFFER_SIZE;
+
+namespace Boards {
+
+/// Xteink X4: 4.26" 800x480, SSD1677
+using X4 = Geometry<800, 480, BitOrder::MSB_FIRST, Polarity::ONE_IS_WHITE>;
+/// 4.2" 400x300, SSD1683
+using Ssd1683_400x300 = Geometry<400, 300, BitOrder::MSB_FIRST, Polarity::ONE_IS_WHITE>;
+/// 2.9" 128x296 portrait, SSD1680
+using Ssd1680_128x296 = Geometry<128, 296, BitOrder::MSB_FIRST, Polarity::ONE_IS_WHITE>;
+
+}  // namespace Boards
+
+}  // namespace PanelGeometry
+
+#ifndef TRMNL_PANEL
+#define TRMNL_PANEL X4
+#endif
+
+using Panel = PanelGeometry::Boards::TRMNL_PANEL;
@@ -0,0 +1,141 @@
+#include "RefreshPlanner.h"
+
+namespace {
+
+struct CurvePoint {
+    float volts;
+    float factor;
+};
+
+// Single-cell LiPo discharge curve, descending voltage. Interpolated linearly.
+constexpr CurvePoint DISCHARGE_CURVE[] = {
+    {3.85f, 1.0f},
+    {3.70f, 1.5f},
+    {3.60f, 2.0f},
+    {3.50f, 3.0f},
+    {3.40f, 4.0f},
+};
+
+RTC_DATA_ATTR uint32_t rtcLastPlannedSeconds = 0;
+RTC_DATA_ATTR uint32_t rtcWakeLatencyMs = 0;  ///< EWMA, 0 = not measured yet
+
+bool inQuietWindow(const uint16_t minuteOfDay, const uint16_t start, const uint16_t end) {
+    if (start < end) {
+        return minuteOfDay >= start && minuteOfDay < end;
+    }
+    // Window wraps past midnight, e.g. 23:00-06:00.
+    return minuteOfDay >= start || minuteOfDay < end;
+}
+
+uint32_t localSecondOfDay(const time_t utc, const int16_t utcOffsetMinutes) {
+    const int64_t local = static_cast<int64_t>(utc) + static_cast<int64_t>(utcOffsetMinutes) * 60;
+    const int64_t sod = local % 86400;
+    return static_cast<uint32_t>(sod < 0 ? sod + 86400 : sod);
+}
+
+// Seconds from now until the wake that shows the image on the local-time
+// boundary of `align` nearest now + seconds (or the first one after it, when
+// quiet hours already moved the wake).
+uint32_t alignedSleep(const time_t now, const uint32_t seconds, const bool notBefore, const uint32_t align,
+                      const uint32_t lead, const int16_t utcOffsetMinutes) {
+    const int64_t localNow = static_cast<int64_t>(now) + static_cast<int64_t>(utcOffsetMinutes) * 60;
+    const int64_t target = localNow + seconds;
+    int64_t boundary = notBefore ? (target + align - 1) / align * align : (target + align / 2) / align * align;
+    while (boundary - lead <= localNow) {
+        boundary += align;
+    }
+    return static_cast<uint32_t>(boundary - lead - localNow);
+}
+
+}  // namespace
+
+float RefreshPlanner::batteryFactor(const double volts) {
+    constexpr size_t n = sizeof(DISCHARGE_CURVE) / sizeof(DISCHARGE_CURVE[0]);
+
+    // No reading (or USB power above the curve): no scaling.
+    if (volts <= 0.0 || volts >= DISCHARGE_CURVE[0].volts) {
+        return 1.0f;
+    }
+    if (volts <= DISCHARGE_CURVE[n - 1].volts) {
+        return DISCHARGE_CURVE[n - 1].factor;
+    }
+
+    for (size_t i = 1; i < n; ++i) {
+        const CurvePoint& hi = DISCHARGE_CURVE[i - 1];
+        const CurvePoint& lo = DISCHARGE_CURVE[i];
+        if (volts >= lo.volts) {
+            const float t = static_cast<float>((volts - lo.volts) / (hi.volts - lo.volts));
+            return lo.factor + t * (hi.factor - lo.factor);
+        }
+    }
+    return 1.0f;
+}
+
+RefreshPlan RefreshPlanner::plan(const uint32_t serverSeconds, const double batteryVolts, const time_t now,
+                                 const TrmnlConfig& config) {
+    RefreshPlan result;
+    result.serverSeconds = serverSeconds;
+
+    uint32_t seconds = serverSeconds;
+    if (config.batteryAwareRefresh) {
+        result.batteryFactor = batteryFactor(batteryVolts);
+        seconds = static_cast<uint32_t>(static_cast<float>(seconds) * result.batteryFactor);
+    }
+    if (seconds > MAX_SLEEP_SECONDS) {
+        seconds = MAX_SLEEP_SECONDS;
+    }
+
+    result.quietHours = deferPastQuietHours(seconds, now, config);
+
+    if (config.wakeAlignSeconds != 0 && now != 0) {
+        result.aligned = true;
+        result.leadSeconds = wakeLeadSeconds();
+        seconds = alignedSleep(now, seconds, result.quietHours, config.wakeAlignSeconds, result.leadSeconds,
+                               config.utcOffsetMinutes);
+    }
+
+    if (seconds == 0) {
+        seconds = serverSeconds;
+    }
+
+    result.seconds = seconds;
+    rtcLastPlannedSeconds = seconds;
+    return result;
+}
+
+bool RefreshPlanner::deferPastQuietHours(uint32_t& seconds, const time_t now, const TrmnlConfig& config) {
+    if (config.quietHoursStartMin == config.quietHoursEndMin || now == 0) {
+        return false;
+    }
+    const uint32_t wakeSod = localSecondOfDay(now + seconds, config.utcOffsetMinutes);
+    if (!inQuietWindow(static_cast<uint16_t>(wakeSod / 60), config.quietHoursStartMin, config.quietHoursEndMin)) {
+        return false;
+    }
+    const uint32_t nowSod = localSecondOfDay(now, config.utcOffsetMinutes);
+    const uint32_t endSod = static_cast<uint32_t>(config.quietHoursEndMin) * 60u;
+    uint32_t untilEnd = (endSod + 86400u - nowSod) % 86400u;
+    if (untilEnd < seconds) {
+        untilEnd += 86400u;
+    }
+    seconds = untilEnd;
+    return true;
+}
+
+uint32_t RefreshPlanner::lastPlannedSeconds() {
+    return rtcLastPlannedSeconds;
+}
+
+void RefreshPlanner::recordWakeLatency(const uint32_t ms) {
+    if (rtcWakeLatencyMs == 0) {
+        rtcWakeLatencyMs = ms;
+        return;
+    }
+    // Weight 1/4: follows a changed network within a few wakes, ignores one slow one.
+    const int32_t delta = static_cast<int32_t>(ms) - static_cast<int32_t>(rtcWakeLatencyMs);
+    rtcWakeLatencyMs = static_cast<uint32_t>(static_cast<int32_t>(rtcWakeLatencyMs) + delta / 4);
+}
+
+uint32_t RefreshPlanner::wakeLeadSeconds() {
+    const uint32_t ms = (rtcWakeLatencyMs != 0) ? rtcWakeLatencyMs : DEFAULT_WAKE_LATENCY_MS;
+    return (ms + 999u) / 1000u;
+}
@@ -0,0 +1,87 @@
+#pragma once
+
+#include <Arduino.h>
+#include <time.h>
+
+#include "ConfigLoader.h"
+
+/**
+ * @brief Decision returned by RefreshPlanner::plan()
+ */
+struct RefreshPlan {
+    uint32_t seconds;       ///< Deep sleep duration to use
+    uint32_t serverSeconds; ///< Refresh rate requested by the server
+    float batteryFactor;    ///< Multiplier applied from the discharge curve
+    bool quietHours;        ///< True if the wake was pushed to the end of quiet hours
+    bool aligned;           ///< True if the image is due on a wake_align boundary
+    uint32_t leadSeconds;   ///< How much earlier than the boundary the wake is set
+
+    RefreshPlan()
+        : seconds(0), serverSeconds(0), batteryFactor(1.0f), quietHours(false), aligned(false), leadSeconds(0) {}
+};
+
+/**
+ * @brief Battery- and schedule-aware refresh interval planner
+ *
+ * Stretches the server's refresh rate as the battery discharges and pushes
+ * wakes that would land inside the configured quiet hours to the end of the
+ * window. The last decision is kept in RTC memory and reported back to the
+ * server in the Refresh-Rate header so it knows the real cadence.
+ *
+ * With wake_align set, the next image is due on the local-time boundary
+ * nearest the planned wake, e.g. the top of each 5 minutes. The wake itself
+ * is set earlier by the learned wake-to-image latency.
+ */
+class RefreshPlanner {
+public:
+    /**
+     * @brief Plan the next sleep interval
+     *
+     * @param serverSeconds Refresh rate from the /api/display response
+     * @param batteryVolts Current battery voltage (0 if unknown)
+     * @param now Current UTC epoch from WallClock (0 if unknown: quiet hours skipped)
+     * @param config Loaded TrmnlConfig
+     * @return RefreshPlan Interval to sleep and why
+     */
+    static RefreshPlan plan(uint32_t serverSeconds, double batteryVolts, time_t now, const TrmnlConfig& config);
+
+    /**
+     * @brief Push a wake that would land inside quiet hours to their end
+     *
+     * The quiet-hours step of plan() on its own, for sleeps that are not
+     * planned from a server refresh rate (the wake budget backoff).
+     *
+     * @param seconds Sleep duration, lengthened in place if moved
+     * @param now Current UTC epoch from WallClock (0 if unknown: left as is)
+     * @param config Loaded TrmnlConfig
+     * @return true if the wake was moved
+     */
+    static bool deferPastQuietHours(uint32_t& seconds, time_t now, const TrmnlConfig& config);
+
+    /**
+     * @brief Interval chosen on the previous wake, or 0 if none yet
+     */
+    static uint32_t lastPlannedSeconds();
+
+    /**
+     * @brief Feed the time from wake to the new image being on screen
+     *
+     * Averaged in RTC memory and used as the lead for aligned wakes.
+     */
+    static void recordWakeLatency(uint32_t ms);
+
+    /**
+     * @brief Lead applied to aligned wakes, in whole seconds
+     */
+    static uint32_t wakeLeadSeconds();
+
+    /**
+     * @brief Interval multiplier for a battery voltage
+     *
+     * 1.0 on a healthy or charging battery, rising to 4.0 near cut-off.
+     */
+    static float batteryFactor(double volts);
+
+    static constexpr uint32_t MAX_SLEEP_SECONDS = 24u * 3600u;
+    static constexpr uint32_t DEFAULT_WAKE_LATENCY_MS = 10000;  ///< Until one has been measured
+};
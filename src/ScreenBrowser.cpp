@@ -0,0 +1,150 @@
+#include "ScreenBrowser.h"
+
+#include <EInkDisplay.h>
+#include <InputManager.h>
+
+#include <string.h>
+
+#include <memory>
+#include <new>
+
+#include "EnergyMeter.h"
+#include "ImageRenderer.h"
+#include "InputEvents.h"
+#include "ScreenCache.h"
+#include "SdBus.h"
+#include "StatusBar.h"
+
+namespace {
+
+struct Window {
+    uint16_t x;
+    uint16_t y;
+    uint16_t width;
+    uint16_t height;
+};
+
+// Byte-aligned box around every framebuffer byte that differs. False if none does.
+bool changedWindow(const uint8_t* shown, const uint8_t* next, Window& window) {
+    uint16_t top = Panel::HEIGHT;
+    uint16_t bottom = 0;
+    uint16_t left = Panel::WIDTH_BYTES;
+    uint16_t right = 0;
+    for (uint16_t y = 0; y < Panel::HEIGHT; ++y) {
+        const uint8_t* a = shown + static_cast<size_t>(y) * Panel::WIDTH_BYTES;
+        const uint8_t* b = next + static_cast<size_t>(y) * Panel::WIDTH_BYTES;
+        if (memcmp(a, b, Panel::WIDTH_BYTES) == 0) {
+            continue;
+        }
+        uint16_t first = 0;
+        while (a[first] == b[first]) {
+            ++first;
+        }
+        uint16_t last = Panel::WIDTH_BYTES - 1;
+        while (a[last] == b[last]) {
+            --last;
+        }
+        top = (y < top) ? y : top;
+        bottom = y;
+        left = (first < left) ? first : left;
+        right = (last > right) ? last : right;
+    }
+    if (top == Panel::HEIGHT) {
+        return false;
+    }
+    window.x = static_cast<uint16_t>(left * 8u);
+    window.y = top;
+    window.width = static_cast<uint16_t>((right - left + 1u) * 8u);
+    window.height = static_cast<uint16_t>(bottom - top + 1u);
+    return true;
+}
+
+}  // namespace
+
+void ScreenBrowser::run(EInkDisplay& display, InputManager& input, const TrmnlConfig& config) {
+    // Held for the whole session: every press may read the next screen.
+    SdBus::Scope sd;
+    const uint8_t capacity = config.screenCacheSize;
+    const uint8_t count = sd.mounted() ? ScreenCache::count(capacity) : 0;
+    if (count < 2) {
+        return;  // The newest screen is already on the panel
+    }
+
+    // Only held while browsing, with the radio off and nothing else on the
+    // heap, so it does not fragment what TLS needs later.
+    std::unique_ptr<uint8_t[]> preload(new (std::nothrow) uint8_t[ScreenCache::FILE_SIZE]);
+    if (!preload) {
+        return;
+    }
+
+    Serial.printf("Browsing %u cached screens\n", count);
+    uint8_t shown = 0;  // Age of the screen on the panel
+    int preloaded = ScreenCache::load(1, capacity, preload.get()) ? 1 : -1;
+    int direction = 1;  // +1 = older (Back), -1 = newer (Confirm)
+    // After a wake the framebuffer does not hold what the panel shows, so the
+    // first page is drawn whole; later ones only refresh what changed.
+    bool framebufferShown = false;
+    uint8_t windowedTurns = 0;
+
+    EnergyMeter::Scope idle(EnergyMeter::State::IDLE);
+    // The interrupt is attached after the press that woke us, so that press
+    // is never reported here.
+    while (InputEvents::waitForPress(input, IDLE_TIMEOUT_MS)) {
+        if (InputEvents::powerPressed()) {
+            break;
+        }
+
+        int target = -1;
+        if (input.wasPressed(InputManager::BTN_BACK) && shown + 1 < count) {
+            target = shown + 1;
+            direction = 1;
+        } else if (input.wasPressed(InputManager::BTN_CONFIRM) && shown > 0) {
+            target = shown - 1;
+            direction = -1;
+        }
+        if (target < 0) {
+            continue;
+        }
+
+        const uint32_t pressMs = InputEvents::pressMs();
+        if (preloaded != target && !ScreenCache::load(static_cast<uint8_t>(target), capacity, preload.get())) {
+            preloaded = -1;
+            continue;
+        }
+        Window window = {0, 0, Panel::WIDTH, Panel::HEIGHT};
+        const bool changed =
+            !framebufferShown ||
+            changedWindow(display.getFrameBuffer(), preload.get() + ImageRenderer::FRAMEBUFFER_HEADER_SIZE, window);
+        if (ImageRenderer::decode(preload.get(), ScreenCache::FILE_SIZE, display) != ImageRenderer::BmpResult::SUCCESS) {
+            preloaded = -1;
+            continue;
+        }
+        const bool windowed = framebufferShown && windowedTurns < FULL_REFRESH_EVERY;
+        if (changed) {
+            EnergyMeter::Scope busy(EnergyMeter::State::DISPLAY);
+            if (windowed) {
+                display.displayWindow(window.x, window.y, window.width, window.height);
+                ++windowedTurns;
+            } else {
+                display.displayBuffer(EInkDisplay::FAST_REFRESH, false);
+                windowedTurns = 0;
+            }
+        }
+        framebufferShown = true;
+        shown = static_cast<uint8_t>(target);
+        if (shown > 0) {
+            // The dashboard StatusBar remembers is gone; the next fetch must repaint.
+            StatusBar::screenReplaced();
+        }
+        Serial.printf("Screen %u/%u in %lu ms (%s%s)\n", shown + 1, count, static_cast<unsigned long>(millis() - pressMs),
+                      !changed ? "unchanged" : windowed ? "window" : "full frame",
+                      preloaded == target ? ", preloaded" : "");
+
+        // The framebuffer now holds the screen, so the buffer is free for the next one.
+        const int next = target + direction;
+        preloaded = (next >= 0 && next < count && ScreenCache::load(static_cast<uint8_t>(next), capacity, preload.get()))
+                        ? next
+                        : -1;
+    }
+    Serial.println("Leaving screen browser");
+}
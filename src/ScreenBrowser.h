@@ -0,0 +1,34 @@
+#pragma once
+
+#include <Arduino.h>
+
+#include "ConfigLoader.h"
+
+class EInkDisplay;
+class InputManager;
+
+/**
+ * @brief Offline paging through the screens in ScreenCache
+ *
+ * Entered on a power-button wake before the radio is started. Back shows
+ * the next older screen, Confirm the next newer one. While a screen is on
+ * the panel, the one after it in the current direction is read from SD into
+ * a RAM buffer, so a press costs only a memcpy and a panel update. Power,
+ * or IDLE_TIMEOUT_MS without a press, leaves for the normal boot flow.
+ *
+ * The first page of a session is a full fast refresh, because after a wake
+ * the framebuffer does not match the panel. Later pages refresh only the
+ * byte-aligned window of pixels that differ, with a partial update. Every
+ * FULL_REFRESH_EVERY windowed pages, a full refresh clears the ghosting that
+ * partial updates leave behind.
+ */
+class ScreenBrowser {
+public:
+    /**
+     * @brief Browse until the user leaves; returns immediately if the cache is empty
+     */
+    static void run(EInkDisplay& display, InputManager& input, const TrmnlConfig& config);
+
+    static constexpr uint32_t IDLE_TIMEOUT_MS = 30000;
+    static constexpr uint8_t FULL_REFRESH_EVERY = 8;
+};
@@ -0,0 +1,114 @@
+#include "ScreenCache.h"
+
+#include <EInkDisplay.h>
+#include <SDCardManager.h>
+
+#include "ImageRenderer.h"
+
+namespace {
+
+constexpr const char* SCREEN_DIR = "/.trmnl/screens";
+constexpr const char* INDEX_PATH = "/.trmnl/screens/index";
+constexpr uint32_t INDEX_MAGIC = 0x4E524353;  // "SCRN"
+
+static_assert(ScreenCache::FILE_SIZE == ImageRenderer::FRAMEBUFFER_HEADER_SIZE + Panel::BUFFER_SIZE,
+              "Screen files use the raw framebuffer format");
+
+struct Index {
+    uint32_t magic;
+    uint8_t next;      ///< Slot the next save goes to
+    uint8_t count;     ///< Valid screens, newest at next - 1
+    uint8_t capacity;  ///< Ring size the slots were written with
+    uint8_t reserved;
+};
+
+void slotPath(char (&path)[40], const uint8_t slot) {
+    snprintf(path, sizeof(path), "%s/%u.fb", SCREEN_DIR, slot);
+}
+
+bool readIndex(Index& index, const uint8_t capacity) {
+    memset(&index, 0, sizeof(index));
+    FsFile file = SdMan.open(INDEX_PATH, O_RDONLY);
+    if (!file) {
+        return false;
+    }
+    const int r = file.read(reinterpret_cast<uint8_t*>(&index), sizeof(index));
+    file.close();
+    return r == static_cast<int>(sizeof(index)) && index.magic == INDEX_MAGIC && index.capacity == capacity &&
+           index.next < capacity && index.count <= capacity;
+}
+
+bool writeIndex(const Index& index) {
+    FsFile file = SdMan.open(INDEX_PATH, O_WRONLY | O_CREAT | O_TRUNC);
+    if (!file) {
+        return false;
+    }
+    const size_t written = file.write(reinterpret_cast<const uint8_t*>(&index), sizeof(index));
+    file.close();
+    return written == sizeof(index);
+}
+
+}  // namespace
+
+bool ScreenCache::save(const uint8_t* framebuffer, const uint8_t capacity) {
+    if (capacity == 0 || framebuffer == nullptr || !SdMan.ready()) {
+        return false;
+    }
+    if (!SdMan.exists(SCREEN_DIR)) {
+        SdMan.mkdir(SCREEN_DIR);
+    }
+
+    Index index;
+    if (!readIndex(index, capacity)) {
+        memset(&index, 0, sizeof(index));
+        index.magic = INDEX_MAGIC;
+        index.capacity = capacity;
+    }
+
+    uint8_t header[ImageRenderer::FRAMEBUFFER_HEADER_SIZE];
+    ImageRenderer::makeFramebufferHeader(framebuffer, header);
+
+    char path[40];
+    slotPath(path, index.next);
+    FsFile file = SdMan.open(path, O_WRONLY | O_CREAT | O_TRUNC);
+    if (!file) {
+        return false;
+    }
+    size_t written = file.write(header, sizeof(header));
+    written += file.write(framebuffer, Panel::BUFFER_SIZE);
+    file.close();
+    if (written != FILE_SIZE) {
+        return false;
+    }
+
+    index.next = static_cast<uint8_t>((index.next + 1) % capacity);
+    if (index.count < capacity) {
+        index.count++;
+    }
+    return writeIndex(index);
+}
+
+uint8_t ScreenCache::count(const uint8_t capacity) {
+    Index index;
+    if (capacity == 0 || !SdMan.ready() || !readIndex(index, capacity)) {
+        return 0;
+    }
+    return index.count;
+}
+
+bool ScreenCache::load(const uint8_t age, const uint8_t capacity, uint8_t* buffer) {
+    Index index;
+    if (capacity == 0 || !SdMan.ready() || !readIndex(index, capacity) || age >= index.count) {
+        return false;
+    }
+
+    char path[40];
+    slotPath(path, static_cast<uint8_t>((index.next + capacity - 1 - age) % capacity));
+    FsFile file = SdMan.open(path, O_RDONLY);
+    if (!file) {
+        return false;
+    }
+    const int r = file.read(buffer, FILE_SIZE);
+    file.close();
+    return r == static_cast<int>(FILE_SIZE);
+}
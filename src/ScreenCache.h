@@ -0,0 +1,45 @@
+#pragma once
+
+#include <Arduino.h>
+
+#include "PanelGeometry.h"
+
+/**
+ * @brief The last few rendered screens, kept on the SD card
+ *
+ * After each successful render the framebuffer (status strip included) is
+ * written to /.trmnl/screens/<slot>.fb in the raw framebuffer format from
+ * ImageRenderer (header + CRC + panel-layout pixels), so loading one back is
+ * a file read and a memcpy. Slots form a ring of config.screenCacheSize
+ * entries, and a small index file records the newest slot and the count.
+ *
+ * Every call runs after display.begin(), so the caller must hold an
+ * SdBus::Scope; without one the card cannot answer and each call fails.
+ */
+class ScreenCache {
+public:
+    /**
+     * @brief Save a framebuffer as the newest screen
+     *
+     * @param framebuffer Panel::BUFFER_SIZE bytes in panel layout
+     * @param capacity Ring size (config.screenCacheSize); a change resets the cache
+     * @return true if the screen and index were written
+     */
+    static bool save(const uint8_t* framebuffer, uint8_t capacity);
+
+    /**
+     * @brief Number of screens available for capacity (0 if none or SD not ready)
+     */
+    static uint8_t count(uint8_t capacity);
+
+    /**
+     * @brief Read a screen file into buffer
+     *
+     * @param age 0 = newest, count() - 1 = oldest
+     * @param buffer FILE_SIZE bytes; pass to ImageRenderer::render() to show it
+     * @return true if a full file was read (the CRC is checked when rendering)
+     */
+    static bool load(uint8_t age, uint8_t capacity, uint8_t* buffer);
+
+    static constexpr size_t FILE_SIZE = 16 + Panel::BUFFER_SIZE;  ///< FRAMEBUFFER_HEADER_SIZE + BUFFER_SIZE
+};
@@ -0,0 +1,16 @@
+#include "SdBus.h"
+
+#include <SDCardManager.h>
+#include <SPI.h>
+
+bool SdBus::acquire() {
+    // SPIClass::begin() is a no-op while the bus is up, so the pins only change across end().
+    SPI.end();
+    SPI.begin(SCLK_PIN, MISO_PIN, MOSI_PIN, -1);
+    return SdMan.begin();
+}
+
+void SdBus::release() {
+    SPI.end();
+    SPI.begin(SCLK_PIN, -1, MOSI_PIN, EPD_CS_PIN);
+}
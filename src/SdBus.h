@@ -0,0 +1,47 @@
+#pragma once
+
+#include <Arduino.h>
+
+/**
+ * @brief SD card access after display.begin()
+ *
+ * The panel and the SD card share one SPI bus. display.begin() sets it up
+ * without MISO, since the panel is write-only, but SD in SPI mode needs MISO
+ * for every response. Code that reads config or telemetry does so before
+ * display.begin(). Anything later takes a Scope, which brings the bus up with
+ * MISO, (re)mounts the card, and restores the display's setup when it ends.
+ */
+class SdBus {
+public:
+    // X4 wiring: SCLK and MOSI are shared, MISO is the card's data out.
+    static constexpr int8_t SCLK_PIN = 8;
+    static constexpr int8_t MOSI_PIN = 10;
+    static constexpr int8_t MISO_PIN = 7;
+    static constexpr int8_t EPD_CS_PIN = 21;
+
+    class Scope {
+    public:
+        Scope() : _mounted(SdBus::acquire()) {}
+        ~Scope() { SdBus::release(); }
+
+        /**
+         * @brief Whether the card mounted; SdMan calls fail otherwise
+         */
+        bool mounted() const { return _mounted; }
+
+    private:
+        bool _mounted;
+    };
+
+    /**
+     * @brief Attach MISO and mount the card
+     *
+     * @return true if SdMan is ready
+     */
+    static bool acquire();
+
+    /**
+     * @brief Give the bus back to the panel, as display.begin() left it
+     */
+    static void release();
+};
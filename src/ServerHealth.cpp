@@ -0,0 +1,135 @@
+#include "ServerHealth.h"
+
+#include <esp_rom_crc.h>
+
+#include <string.h>
+
+#include <algorithm>
+
+namespace {
+
+constexpr uint32_t RTC_MAGIC = 0x53525648;  // "SRVH"
+constexpr uint16_t TTFB_UNKNOWN = 0;
+
+struct ServerStats {
+    uint32_t urlHash;
+    uint16_t ttfbMs;      ///< EWMA, TTFB_UNKNOWN until the first response
+    uint8_t successPct;   ///< EWMA of successes, 0-100
+    uint8_t failStreak;   ///< Consecutive failures
+};
+
+struct RtcServerHealth {
+    uint32_t magic;
+    uint16_t wakesSinceProbe;
+    uint16_t reserved;
+    ServerStats servers[TrmnlConfig::MAX_SERVER_URLS];
+};
+
+RTC_DATA_ATTR RtcServerHealth rtcHealth;
+
+uint32_t urlHash(const String& url) {
+    return esp_rom_crc32_le(0, reinterpret_cast<const uint8_t*>(url.c_str()), url.length());
+}
+
+bool healthy(const ServerStats& stats) {
+    return stats.successPct >= ServerHealth::UNHEALTHY_SUCCESS_PCT &&
+           stats.failStreak < ServerHealth::UNHEALTHY_FAIL_STREAK;
+}
+
+// Lower sorts first: healthy and measured, then not yet measured, then unhealthy.
+uint32_t rankKey(const ServerStats& stats) {
+    if (!healthy(stats)) {
+        return 0x20000u;
+    }
+    if (stats.ttfbMs == TTFB_UNKNOWN) {
+        return 0x10000u;
+    }
+    return stats.ttfbMs;
+}
+
+// Re-key the RTC slots to the current config order, keeping stats for URLs
+// that were already known.
+void bindToConfig(const TrmnlConfig& config) {
+    RtcServerHealth previous = rtcHealth;
+    const bool valid = previous.magic == RTC_MAGIC;
+
+    memset(&rtcHealth, 0, sizeof(rtcHealth));
+    rtcHealth.magic = RTC_MAGIC;
+    rtcHealth.wakesSinceProbe = valid ? previous.wakesSinceProbe : 0;
+
+    for (size_t i = 0; i < config.serverUrls.size() && i < TrmnlConfig::MAX_SERVER_URLS; ++i) {
+        ServerStats& stats = rtcHealth.servers[i];
+        stats.urlHash = urlHash(config.serverUrls[i]);
+        stats.ttfbMs = TTFB_UNKNOWN;
+        stats.successPct = 100;
+        stats.failStreak = 0;
+        if (!valid) {
+            continue;
+        }
+        for (const ServerStats& old : previous.servers) {
+            if (old.urlHash == stats.urlHash && old.successPct <= 100) {
+                stats = old;
+                break;
+            }
+        }
+    }
+}
+
+}  // namespace
+
+size_t ServerHealth::rank(const TrmnlConfig& config, uint8_t order[TrmnlConfig::MAX_SERVER_URLS]) {
+    bindToConfig(config);
+
+    const size_t count = std::min(config.serverUrls.size(), TrmnlConfig::MAX_SERVER_URLS);
+    for (size_t i = 0; i < count; ++i) {
+        order[i] = static_cast<uint8_t>(i);
+    }
+
+    // Stable insertion sort: ties keep the configured order.
+    for (size_t i = 1; i < count; ++i) {
+        const uint8_t index = order[i];
+        const uint32_t key = rankKey(rtcHealth.servers[index]);
+        size_t j = i;
+        while (j > 0 && rankKey(rtcHealth.servers[order[j - 1]]) > key) {
+            order[j] = order[j - 1];
+            --j;
+        }
+        order[j] = index;
+    }
+
+    rtcHealth.wakesSinceProbe++;
+    if (rtcHealth.wakesSinceProbe >= PROBE_INTERVAL_WAKES) {
+        for (size_t i = 1; i < count; ++i) {
+            if (!healthy(rtcHealth.servers[order[i]])) {
+                const uint8_t probe = order[i];
+                memmove(order + 1, order, i);
+                order[0] = probe;
+                break;
+            }
+        }
+        rtcHealth.wakesSinceProbe = 0;
+    }
+    return count;
+}
+
+void ServerHealth::recordSuccess(const size_t index, const uint32_t ttfbMs) {
+    if (rtcHealth.magic != RTC_MAGIC || index >= TrmnlConfig::MAX_SERVER_URLS) {
+        return;
+    }
+    ServerStats& stats = rtcHealth.servers[index];
+    const uint16_t sample = static_cast<uint16_t>(std::min<uint32_t>(std::max<uint32_t>(ttfbMs, 1), 0xFFFF));
+    stats.ttfbMs = stats.ttfbMs == TTFB_UNKNOWN ? sample : static_cast<uint16_t>((3u * stats.ttfbMs + sample) / 4u);
+    stats.successPct = static_cast<uint8_t>((3u * stats.successPct + 100u) / 4u);
+    stats.failStreak = 0;
+}
+
+void ServerHealth::recordFailure(const size_t index) {
+    if (rtcHealth.magic != RTC_MAGIC || index >= TrmnlConfig::MAX_SERVER_URLS) {
+        return;
+    }
+    ServerStats& stats = rtcHealth.servers[index];
+    stats.successPct = static_cast<uint8_t>((3u * stats.successPct) / 4u);
+    if (stats.failStreak < 0xFF) {
+        stats.failStreak++;
+    }
+}
@@ -0,0 +1,45 @@
+#pragma once
+
+#include <Arduino.h>
+
+#include "ConfigLoader.h"
+
+/**
+ * @brief Per-server health and latency tracking for server_url failover
+ *
+ * Keeps a success rate and time-to-first-byte (both exponentially weighted)
+ * for each configured server in RTC memory, keyed by a hash of the URL so
+ * reordering or editing server_url keeps or resets stats as expected.
+ *
+ * rank() orders healthy servers fastest first, then servers with no data
+ * yet, then unhealthy ones. Every PROBE_INTERVAL_WAKES, the first unhealthy
+ * server is tried first instead so a recovered primary is picked up again.
+ */
+class ServerHealth {
+public:
+    /**
+     * @brief Order the configured servers for this wake
+     *
+     * @param config Loaded TrmnlConfig
+     * @param order Output: indexes into config.serverUrls, best first
+     * @return Number of entries written (config.serverUrls.size())
+     */
+    static size_t rank(const TrmnlConfig& config, uint8_t order[TrmnlConfig::MAX_SERVER_URLS]);
+
+    /**
+     * @brief Record a response (any HTTP status below 500) from a server
+     *
+     * @param index Index into config.serverUrls, as returned by rank()
+     * @param ttfbMs Milliseconds from starting the request to the response headers
+     */
+    static void recordSuccess(size_t index, uint32_t ttfbMs);
+
+    /**
+     * @brief Record a connect failure, timeout or 5xx from a server
+     */
+    static void recordFailure(size_t index);
+
+    static constexpr uint8_t UNHEALTHY_SUCCESS_PCT = 50;
+    static constexpr uint8_t UNHEALTHY_FAIL_STREAK = 2;
+    static constexpr uint16_t PROBE_INTERVAL_WAKES = 8;
+};
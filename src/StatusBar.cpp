@@ -0,0 +1,194 @@
+#include "StatusBar.h"
+
+#include <BatteryMonitor.h>
+#include <EInkDisplay.h>
+#include <WiFi.h>
+#include <esp_rom_crc.h>
+
+#include <string.h>
+#include <time.h>
+
+#include "EnergyMeter.h"
+#include "PanelGeometry.h"
+#include "TextDraw.h"
+#include "WallClock.h"
+
+namespace {
+
+constexpr uint32_t RTC_MAGIC = 0x53544154;  // "STAT"
+constexpr size_t COLUMNS = Panel::WIDTH / 8;
+constexpr uint16_t TEXT_ROW = 2;  ///< First glyph row within the strip
+
+struct RtcStatus {
+    uint32_t magic;
+    uint32_t lastSuccessEpoch;  ///< 0 = never, or before the clock was set
+    uint16_t failedWakes;       ///< Since the last success
+    bool dashboardShown;        ///< Panel shows a fetched image, not an error screen
+    uint32_t lastTextCrc;       ///< Strip text last sent to the panel
+    uint32_t frameHash;         ///< ImageRenderer::frameHash() of that image, without the strip
+    uint16_t unchangedInRow;    ///< Refreshes skipped since the image last changed
+    uint32_t unchangedTotal;    ///< Refreshes skipped since power-on
+};
+
+RTC_DATA_ATTR RtcStatus rtcStatus;
+
+void ensureState() {
+    if (rtcStatus.magic != RTC_MAGIC) {
+        memset(&rtcStatus, 0, sizeof(rtcStatus));
+        rtcStatus.magic = RTC_MAGIC;
+    }
+}
+
+uint16_t stripTop(const StatusBarPosition position) {
+    return position == StatusBarPosition::TOP ? 0 : Panel::HEIGHT - StatusBar::HEIGHT;
+}
+
+// One line of exactly COLUMNS characters: readings on the left, check-in
+// time and error count on the right.
+void formatText(char (&line)[COLUMNS + 1], const TrmnlConfig& config, const BatteryMonitor& battery) {
+    char left[48];
+    const int rssi = WiFi.status() == WL_CONNECTED ? WiFi.RSSI() : 0;
+    if (rssi != 0) {
+        snprintf(left, sizeof(left), " BAT %u%% %.2fV  WIFI %ddBm", battery.readPercentage(), battery.readVolts(), rssi);
+    } else {
+        snprintf(left, sizeof(left), " BAT %u%% %.2fV  WIFI --", battery.readPercentage(), battery.readVolts());
+    }
+
+    char right[32];
+    char clock[6] = "--:--";
+    if (rtcStatus.lastSuccessEpoch != 0) {
+        const time_t local = static_cast<time_t>(rtcStatus.lastSuccessEpoch) + config.utcOffsetMinutes * 60;
+        struct tm parts;
+        gmtime_r(&local, &parts);
+        snprintf(clock, sizeof(clock), "%02d:%02d", parts.tm_hour, parts.tm_min);
+    }
+    if (rtcStatus.failedWakes > 0) {
+        snprintf(right, sizeof(right), "ERR %u  UPD %s ", rtcStatus.failedWakes, clock);
+    } else {
+        snprintf(right, sizeof(right), "UPD %s ", clock);
+    }
+
+    memset(line, ' ', COLUMNS);
+    line[COLUMNS] = '\0';
+    memcpy(line, left, strnlen(left, COLUMNS));
+    const size_t rightLength = strnlen(right, COLUMNS);
+    memcpy(line + COLUMNS - rightLength, right, rightLength);
+}
+
+// Write the strip rows: a 1 px rule on the edge facing the image, the text
+// as whole glyph bytes, white elsewhere.
+template <class P>
+void blitStrip(uint8_t* framebuffer, const StatusBarPosition position, const char (&line)[COLUMNS + 1]) {
+    uint8_t* strip = framebuffer + static_cast<size_t>(stripTop(position)) * P::WIDTH_BYTES;
+    const uint16_t ruleRow = position == StatusBarPosition::TOP ? StatusBar::HEIGHT - 1 : 0;
+
+    for (uint16_t row = 0; row < StatusBar::HEIGHT; ++row) {
+        uint8_t* dst = strip + static_cast<size_t>(row) * P::WIDTH_BYTES;
+        if (row == ruleRow) {
+            memset(dst, P::BLACK_BYTE, P::WIDTH_BYTES);
+        } else if (row >= TEXT_ROW && row < TEXT_ROW + 8) {
+            for (size_t col = 0; col < COLUMNS; ++col) {
+                dst[col] = P::fromMsbInk(TextDraw::glyph(line[col])[row - TEXT_ROW]);
+            }
+        } else {
+            memset(dst, P::WHITE_BYTE, P::WIDTH_BYTES);
+        }
+    }
+}
+
+void blit(EInkDisplay& display, const StatusBarPosition position, const char (&line)[COLUMNS + 1]) {
+    blitStrip<Panel>(display.getFrameBuffer(), position, line);
+}
+
+uint32_t textCrc(const char (&line)[COLUMNS + 1], const StatusBarPosition position) {
+    return esp_rom_crc32_le(static_cast<uint32_t>(position), reinterpret_cast<const uint8_t*>(line), COLUMNS);
+}
+
+}  // namespace
+
+void StatusBar::recordSuccess() {
+    ensureState();
+    rtcStatus.lastSuccessEpoch = static_cast<uint32_t>(WallClock::now());
+    rtcStatus.failedWakes = 0;
+}
+
+void StatusBar::recordFailure(const bool errorShown) {
+    ensureState();
+    if (rtcStatus.failedWakes < UINT16_MAX) {
+        rtcStatus.failedWakes++;
+    }
+    if (errorShown) {
+        rtcStatus.dashboardShown = false;
+    }
+}
+
+uint16_t StatusBar::failedWakes() {
+    ensureState();
+    return rtcStatus.failedWakes;
+}
+
+void StatusBar::screenReplaced() {
+    ensureState();
+    rtcStatus.dashboardShown = false;
+}
+
+bool StatusBar::showsFrame(const uint32_t frameHash) {
+    ensureState();
+    return rtcStatus.dashboardShown && rtcStatus.frameHash == frameHash;
+}
+
+void StatusBar::recordUnchangedFrame() {
+    ensureState();
+    if (rtcStatus.unchangedInRow < UINT16_MAX) {
+        rtcStatus.unchangedInRow++;
+    }
+    rtcStatus.unchangedTotal++;
+}
+
+uint16_t StatusBar::unchangedInRow() {
+    ensureState();
+    return rtcStatus.unchangedInRow;
+}
+
+uint32_t StatusBar::unchangedTotal() {
+    ensureState();
+    return rtcStatus.unchangedTotal;
+}
+
+void StatusBar::compose(EInkDisplay& display, const TrmnlConfig& config, const BatteryMonitor& battery,
+                        const uint32_t frameHash) {
+    ensureState();
+    rtcStatus.dashboardShown = true;
+    rtcStatus.frameHash = frameHash;
+    rtcStatus.unchangedInRow = 0;
+    if (config.statusBar == StatusBarPosition::OFF) {
+        return;
+    }
+
+    char line[COLUMNS + 1];
+    formatText(line, config, battery);
+    blit(display, config.statusBar, line);
+    rtcStatus.lastTextCrc = textCrc(line, config.statusBar);
+}
+
+bool StatusBar::refresh(EInkDisplay& display, const TrmnlConfig& config, const BatteryMonitor& battery) {
+    ensureState();
+    if (config.statusBar == StatusBarPosition::OFF || !rtcStatus.dashboardShown) {
+        return false;
+    }
+
+    char line[COLUMNS + 1];
+    formatText(line, config, battery);
+    const uint32_t crc = textCrc(line, config.statusBar);
+    if (crc == rtcStatus.lastTextCrc) {
+        return false;
+    }
+
+    blit(display, config.statusBar, line);
+    {
+        EnergyMeter::Scope busy(EnergyMeter::State::DISPLAY);
+        display.displayWindow(0, stripTop(config.statusBar), Panel::WIDTH, HEIGHT);
+    }
+    rtcStatus.lastTextCrc = crc;
+    return true;
+}
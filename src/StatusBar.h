@@ -0,0 +1,95 @@
+#pragma once
+
+#include <Arduino.h>
+
+#include "ConfigLoader.h"
+
+class BatteryMonitor;
+class EInkDisplay;
+
+/**
+ * @brief Device status strip composited over the fetched image
+ *
+ * A HEIGHT-pixel, full-width strip at the top or bottom of the panel
+ * (config "status_bar") showing battery, RSSI, the time of the last
+ * successful server check-in, and the number of failed wakes since then.
+ * The server knows none of these.
+ *
+ * The strip is built from whole glyph bytes (8 px wide, byte-aligned), so
+ * composing it writes only the strip's rows of the framebuffer and never
+ * reads or shifts the image around it. On wakes where the server reports no
+ * new image, refresh() redraws just the strip with a partial refresh.
+ *
+ * Check-in time, failure count and whether the panel currently shows a
+ * dashboard are kept in RTC memory across deep sleep. So is the frame hash
+ * of that dashboard, which lets a wake that fetched the same pixels under a
+ * new image URL skip the full refresh (showsFrame()).
+ */
+class StatusBar {
+public:
+    /**
+     * @brief Note a successful /api/display call (new image or 202)
+     */
+    static void recordSuccess();
+
+    /**
+     * @brief Note a failed wake
+     *
+     * @param errorShown false if the panel was left showing the last dashboard
+     */
+    static void recordFailure(bool errorShown = true);
+
+    /**
+     * @brief Failed wakes since the last successful check-in
+     */
+    static uint16_t failedWakes();
+
+    /**
+     * @brief Note that something other than a dashboard (e.g. the boot menu) was drawn full-screen
+     */
+    static void screenReplaced();
+
+    /**
+     * @brief Write the strip into the framebuffer (before the full refresh)
+     *
+     * Writes nothing when the strip is off, but always records the image as
+     * the dashboard on the panel. Call after the image was decoded.
+     *
+     * @param frameHash ImageRenderer::frameHash() of the image, taken before the strip was drawn
+     */
+    static void compose(EInkDisplay& display, const TrmnlConfig& config, const BatteryMonitor& battery,
+                        uint32_t frameHash);
+
+    /**
+     * @brief Whether the panel already shows the dashboard with this frame hash
+     */
+    static bool showsFrame(uint32_t frameHash);
+
+    /**
+     * @brief Note a wake whose new image matched the panel, so no refresh was done
+     */
+    static void recordUnchangedFrame();
+
+    /**
+     * @brief Refreshes skipped since the image last changed
+     */
+    static uint16_t unchangedInRow();
+
+    /**
+     * @brief Refreshes skipped since power-on
+     */
+    static uint32_t unchangedTotal();
+
+    /**
+     * @brief Redraw only the strip over the image already on the panel
+     *
+     * Skipped when the strip is off, when the panel does not show a dashboard
+     * (e.g. an error screen from an earlier wake), or when the text is
+     * unchanged since it was last drawn.
+     *
+     * @return true if a partial refresh was done
+     */
+    static bool refresh(EInkDisplay& display, const TrmnlConfig& config, const BatteryMonitor& battery);
+
+    static constexpr uint16_t HEIGHT = 12;
+};
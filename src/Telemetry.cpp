@@ -0,0 +1,164 @@
+#include "Telemetry.h"
+
+#include <SDCardManager.h>
+
+#include <stdio.h>
+#include <string.h>
+
+#include <algorithm>
+
+#include "WallClock.h"
+
+namespace {
+
+constexpr uint32_t RTC_MAGIC = 0x54454C4D;  // "TELM"
+constexpr const char* LOG_DIR = "/.trmnl/log";
+constexpr const char* CURRENT_SEGMENT = "/.trmnl/log/events.bin";
+
+struct SegmentHeader {
+    uint32_t magic;
+    uint16_t version;
+    uint16_t recordSize;
+    uint8_t reserved[8];
+};
+static_assert(sizeof(SegmentHeader) == 16, "SegmentHeader layout is decoded on the host");
+
+struct RtcLog {
+    uint32_t magic;
+    uint16_t head;     ///< Next slot to write
+    uint16_t count;    ///< Pending records
+    uint32_t dropped;  ///< Records overwritten before they reached SD
+    uint32_t wakeSeq;
+    Telemetry::Record records[Telemetry::RTC_CAPACITY];
+};
+
+RTC_DATA_ATTR RtcLog rtcLog;
+
+void segmentPath(const uint8_t index, char* out, const size_t outSize) {
+    if (index == 0) {
+        strlcpy(out, CURRENT_SEGMENT, outSize);
+    } else {
+        snprintf(out, outSize, "%s/events.%u.bin", LOG_DIR, static_cast<unsigned>(index));
+    }
+}
+
+void renameFile(const char* from, const char* to) {
+    FsFile file = SdMan.open(from, O_RDWR);
+    if (file) {
+        file.rename(to);
+        file.close();
+    }
+}
+
+void rotateSegments() {
+    char from[40];
+    char to[40];
+
+    segmentPath(Telemetry::MAX_SEGMENTS - 1, to, sizeof(to));
+    if (SdMan.exists(to)) {
+        SdMan.remove(to);
+    }
+    for (uint8_t i = Telemetry::MAX_SEGMENTS - 1; i > 0; --i) {
+        segmentPath(i - 1, from, sizeof(from));
+        segmentPath(i, to, sizeof(to));
+        if (SdMan.exists(from)) {
+            renameFile(from, to);
+        }
+    }
+}
+
+FsFile openCurrentSegment() {
+    FsFile file = SdMan.open(CURRENT_SEGMENT, O_RDWR | O_CREAT | O_AT_END);
+    if (file && file.size() == 0) {
+        SegmentHeader header = {};
+        header.magic = Telemetry::FILE_MAGIC;
+        header.version = Telemetry::FILE_VERSION;
+        header.recordSize = sizeof(Telemetry::Record);
+        file.write(reinterpret_cast<const uint8_t*>(&header), sizeof(header));
+    }
+    return file;
+}
+
+}  // namespace
+
+void Telemetry::begin() {
+    if (rtcLog.magic != RTC_MAGIC || rtcLog.head >= RTC_CAPACITY || rtcLog.count > RTC_CAPACITY) {
+        memset(&rtcLog, 0, sizeof(rtcLog));
+        rtcLog.magic = RTC_MAGIC;
+    }
+    rtcLog.wakeSeq++;
+}
+
+void Telemetry::record(const Event event, const int32_t a0, const int32_t a1, const int32_t a2) {
+    Record& rec = rtcLog.records[rtcLog.head];
+    rec.epoch = static_cast<uint32_t>(WallClock::now());
+    rec.uptimeMs = millis();
+    rec.event = static_cast<uint16_t>(event);
+    rec.wake = static_cast<uint16_t>(rtcLog.wakeSeq);
+    rec.args[0] = a0;
+    rec.args[1] = a1;
+    rec.args[2] = a2;
+
+    rtcLog.head = static_cast<uint16_t>((rtcLog.head + 1) % RTC_CAPACITY);
+    if (rtcLog.count < RTC_CAPACITY) {
+        rtcLog.count++;
+    } else {
+        rtcLog.dropped++;
+    }
+}
+
+bool Telemetry::needsFlush() {
+    return rtcLog.magic == RTC_MAGIC && rtcLog.count >= (RTC_CAPACITY * 3) / 4;
+}
+
+bool Telemetry::flush() {
+    if (rtcLog.dropped != 0) {
+        const uint32_t dropped = rtcLog.dropped;
+        rtcLog.dropped = 0;
+        record(Event::RECORDS_DROPPED, static_cast<int32_t>(dropped));
+    }
+    if (rtcLog.count == 0) {
+        return true;
+    }
+    if (!SdMan.ready()) {
+        return false;
+    }
+    if (!SdMan.exists(LOG_DIR)) {
+        SdMan.mkdir(LOG_DIR);
+    }
+
+    const size_t batchBytes = static_cast<size_t>(rtcLog.count) * sizeof(Record);
+    FsFile file = openCurrentSegment();
+    if (!file) {
+        return false;
+    }
+    if (file.size() + batchBytes > SEGMENT_MAX_BYTES) {
+        file.close();
+        rotateSegments();
+        file = openCurrentSegment();
+        if (!file) {
+            return false;
+        }
+    }
+
+    // A short write leaves a torn record behind, which would misalign every
+    // record after it; cut the segment back so the batch is all or nothing.
+    const uint64_t startSize = file.size();
+
+    // Oldest record sits at head once the ring has wrapped. At most two writes.
+    const size_t tail = (rtcLog.head + RTC_CAPACITY - rtcLog.count) % RTC_CAPACITY;
+    const size_t firstRun = std::min<size_t>(rtcLog.count, RTC_CAPACITY - tail);
+    size_t written = file.write(reinterpret_cast<const uint8_t*>(&rtcLog.records[tail]), firstRun * sizeof(Record));
+    if (firstRun < rtcLog.count) {
+        written += file.write(reinterpret_cast<const uint8_t*>(&rtcLog.records[0]),
+                              (rtcLog.count - firstRun) * sizeof(Record));
+    }
+    if (written != batchBytes) {
+        file.truncate(startSize);
+        file.close();
+        return false;
+    }
+    file.close();
+    rtcLog.count = 0;
+    return true;
+}
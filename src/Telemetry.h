@@ -0,0 +1,80 @@
+#pragma once
+
+#include <Arduino.h>
+
+/**
+ * @brief Compact binary event log on the SD card
+ *
+ * Events are fixed-size records (timestamp, event ID, three numeric args)
+ * appended to a ring buffer in RTC memory, so recording one costs a struct
+ * copy rather than string formatting and an SD write. Because timer wakes
+ * don't mount SD, records accumulate across wakes. flush() writes everything
+ * pending in one append on the next wake that has the card mounted.
+ *
+ * On SD, /.trmnl/log/events.bin holds the newest records. Once it reaches
+ * SEGMENT_MAX_BYTES it is rotated to events.1.bin ... events.N.bin and the
+ * oldest segment is deleted. tools/telemetry_decode.py converts segments to CSV;
+ * keep its event table in sync with Event below.
+ */
+class Telemetry {
+public:
+    enum class Event : uint16_t {
+        BOOT = 1,            ///< a0=wake cause, a1=reset reason, a2=battery mV
+        CONFIG = 2,          ///< a0=ConfigError, a1=1 if restored from RTC snapshot
+        WIFI_CONNECTED = 3,  ///< a0=association ms, a1=RSSI dBm, a2=associations tried
+        WIFI_FAILED = 4,     ///< a0=wl_status_t, a1=associations tried
+        API_RESPONSE = 5,    ///< a0=HTTP status, a1=request ms, a2=body bytes
+        API_ERROR = 6,       ///< a0=ApiError, a1=HTTP status
+        IMAGE_DOWNLOAD = 7,  ///< a0=HTTP status, a1=download ms, a2=bytes
+        IMAGE_RENDER = 8,    ///< a0=BmpResult, a1=decode ms, a2=refresh ms
+        SLEEP = 9,           ///< a0=sleep s, a1=battery factor x100, a2=1 if quiet hours
+        RECORDS_DROPPED = 10, ///< a0=records lost to RTC buffer overflow
+        OTA = 11,            ///< a0=OtaResult, a1=bytes written, a2=ms
+        SERVER_FAILOVER = 12, ///< a0=server index, a1=HTTP status or error, a2=ms spent
+        DNS_CACHE = 13,      ///< a0=cache hits, a1=lookups, a2=estimated ms saved
+        HEAP = 14,           ///< a0=HeapMonitor::Stage | min free ever << 8, a1=free, a2=largest free block
+        DOWNLOAD_STATS = 15, ///< a0=image body bytes/s, a1=read calls, a2=socket waits
+        CLOCK_SYNC = 16,     ///< a0=system minus server ms, a1=drift estimate ppm, a2=s since previous sync
+        WAKE_BUDGET = 17,    ///< a0=budget ms, a1=failed wakes in a row, a2=backoff s
+        FRAME_UNCHANGED = 18 ///< a0=frame hash, a1=refreshes skipped in a row, a2=skipped since power-on
+    };
+
+    struct Record {
+        uint32_t epoch;     ///< UTC seconds, 0 if the wall clock was not set
+        uint32_t uptimeMs;  ///< millis() at the time of the event
+        uint16_t event;     ///< Event
+        uint16_t wake;      ///< Low 16 bits of the wake sequence number
+        int32_t args[3];
+    };
+    static_assert(sizeof(Record) == 24, "Record layout is decoded on the host");
+
+    static constexpr uint32_t FILE_MAGIC = 0x474F4C54;  // "TLOG"
+    static constexpr uint16_t FILE_VERSION = 1;
+    static constexpr size_t RTC_CAPACITY = 48;
+    static constexpr uint32_t SEGMENT_MAX_BYTES = 64 * 1024;
+    static constexpr uint8_t MAX_SEGMENTS = 4;  ///< events.bin + 3 rotated
+
+    /**
+     * @brief Start a new wake (call once, early in setup())
+     */
+    static void begin();
+
+    /**
+     * @brief Append an event to the RTC buffer (drops the oldest when full)
+     */
+    static void record(Event event, int32_t a0 = 0, int32_t a1 = 0, int32_t a2 = 0);
+
+    /**
+     * @brief True when the RTC buffer is filling up and this wake should mount SD
+     */
+    static bool needsFlush();
+
+    /**
+     * @brief Write all pending records to SD in one append
+     *
+     * SD must be mounted (and, on this board, before display.begin()).
+     *
+     * @return true if the buffer was written (or was already empty)
+     */
+    static bool flush();
+};
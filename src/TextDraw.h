@@ -10,4 +10,12 @@ void drawChar(EInkDisplay& display, char c, int16_t x, int16_t y);
 void drawString(EInkDisplay& display, const char* str, int16_t x, int16_t y);
 void drawCenteredString(EInkDisplay& display, const char* str, int16_t y);
 
+/**
+ * 8x8 glyph rows for c (non-printable characters map to ' ').
+ *
+ * Bit 7 is the leftmost pixel and 1 = ink; at a byte-aligned x a glyph row
+ * becomes the framebuffer byte Panel::fromMsbInk(row).
+ */
+const uint8_t* glyph(char c);
+
 }  // namespace TextDraw
@@ -0,0 +1,63 @@
+#include "WakeBudget.h"
+
+#include "RefreshPlanner.h"
+
+namespace {
+
+bool active = false;
+uint32_t startedAtMs = 0;
+uint32_t budget = 0;
+
+}  // namespace
+
+void WakeBudget::begin(const TrmnlConfig& config, const double batteryVolts, const uint32_t startMs) {
+    startedAtMs = startMs;
+    budget = config.wakeBudgetSeconds * 1000u;
+    active = budget != 0;
+    if (!active) {
+        return;
+    }
+
+    // Same curve as the refresh interval: at 4x the interval, a quarter of the
+    // awake time. Scaling stops at MIN_BUDGET_MS; a smaller wake_budget stays as set.
+    if (config.batteryAwareRefresh) {
+        const uint32_t scaled =
+            static_cast<uint32_t>(static_cast<float>(budget) / RefreshPlanner::batteryFactor(batteryVolts));
+        const uint32_t floor = (budget < MIN_BUDGET_MS) ? budget : MIN_BUDGET_MS;
+        budget = (scaled > floor) ? scaled : floor;
+    }
+}
+
+void WakeBudget::end() {
+    active = false;
+}
+
+uint32_t WakeBudget::budgetMs() {
+    return active ? budget : 0;
+}
+
+uint32_t WakeBudget::remainingMs() {
+    if (!active) {
+        return UINT32_MAX;
+    }
+    const uint32_t elapsed = millis() - startedAtMs;
+    return (elapsed < budget) ? (budget - elapsed) : 0;
+}
+
+bool WakeBudget::expired() {
+    return remainingMs() < MIN_STEP_MS;
+}
+
+uint32_t WakeBudget::clamp(const uint32_t stepMs) {
+    const uint32_t remaining = remainingMs();
+    return (stepMs < remaining) ? stepMs : remaining;
+}
+
+uint32_t WakeBudget::backoffSeconds(const uint16_t failedWakes, const TrmnlConfig& config) {
+    const uint32_t cap = (config.refreshInterval > MIN_BACKOFF_SECONDS) ? config.refreshInterval : MIN_BACKOFF_SECONDS;
+    uint32_t seconds = MIN_BACKOFF_SECONDS;
+    for (uint16_t i = 1; i < failedWakes && seconds < cap; ++i) {
+        seconds *= 2;
+    }
+    return (seconds < cap) ? seconds : cap;
+}
@@ -0,0 +1,79 @@
+#pragma once
+
+#include <Arduino.h>
+
+#include "ConfigLoader.h"
+
+/**
+ * @brief Single deadline for all network work on one wake
+ *
+ * Each network step used to carry its own timeout (WiFi 20 s, API 30 s,
+ * image 60 s, TLS handshake 120 s), so a bad network could keep the device
+ * awake for minutes. begin() sets one deadline from config "wake_budget",
+ * shortened as the battery drains. WifiConnector, DnsCache, CachedDnsClient,
+ * ApiClient and BulkReader clamp their own waits to remainingMs() and give
+ * up once expired(), and runOnce() then sleeps with a backoff instead of
+ * showing an error; the panel keeps the last image.
+ *
+ * Until begin() is called there is no budget and remainingMs() is UINT32_MAX.
+ */
+class WakeBudget {
+public:
+    /**
+     * @brief Start the deadline for this wake
+     *
+     * @param config Loaded TrmnlConfig (wake_budget 0 = no budget)
+     * @param batteryVolts Current battery voltage (0 if unknown)
+     * @param startMs millis() the budget counts from: 0 on timer wakes, so
+     *                boot and SD time is charged too
+     */
+    static void begin(const TrmnlConfig& config, double batteryVolts, uint32_t startMs);
+
+    /**
+     * @brief Drop the deadline once the wake's own network work is done
+     *
+     * A firmware update is downloaded after the image is shown and has its
+     * own inactivity timeout; cutting it off at the budget would only leave
+     * a half-written slot to be fetched again on the next wake.
+     */
+    static void end();
+
+    /**
+     * @brief Budget set by begin(), in milliseconds (0 = none)
+     */
+    static uint32_t budgetMs();
+
+    /**
+     * @brief Milliseconds left, 0 once past the deadline, UINT32_MAX without a budget
+     */
+    static uint32_t remainingMs();
+
+    /**
+     * @brief Whether too little is left to start another network step
+     */
+    static bool expired();
+
+    /**
+     * @brief A step's own timeout, shortened to what is left of the budget
+     */
+    static uint32_t clamp(uint32_t stepMs);
+
+    /**
+     * @brief Sleep before retrying after a wake that ran out of budget
+     *
+     * Doubles from MIN_BACKOFF_SECONDS with each failed wake in a row, up to
+     * the configured refresh interval.
+     *
+     * @param failedWakes Failed wakes since the last successful check-in, this one included
+     */
+    static uint32_t backoffSeconds(uint16_t failedWakes, const TrmnlConfig& config);
+
+    static constexpr uint32_t DEFAULT_BUDGET_SECONDS = 60;
+    static constexpr uint32_t MAX_BUDGET_SECONDS = 600;
+    /// A low battery shortens the budget, but never below this (or wake_budget, if
+    /// smaller): joining WiFi alone can take 10 s.
+    static constexpr uint32_t MIN_BUDGET_MS = 30000;
+    /// Steps are not started with less than this left.
+    static constexpr uint32_t MIN_STEP_MS = 500;
+    static constexpr uint32_t MIN_BACKOFF_SECONDS = 60;
+};
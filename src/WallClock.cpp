@@ -0,0 +1,169 @@
+#include "WallClock.h"
+
+#include <stdio.h>
+#include <string.h>
+#include <sys/time.h>
+
+#include "Telemetry.h"
+
+namespace {
+
+// Anything earlier means the RTC was never set on this unit.
+constexpr time_t MIN_VALID_EPOCH = 1577836800;  // 2020-01-01
+
+constexpr uint32_t RTC_MAGIC = 0x434C4B44;  // "CLKD"
+
+struct RtcClockState {
+    uint32_t magic;
+    uint32_t lastSyncEpoch;     ///< Server time at the last sync, 0 = never
+    uint32_t sampleStartEpoch;  ///< Sync that opened the pooled drift sample
+    int32_t sampleErrorMs;      ///< Corrections (system minus server) applied since then
+    int32_t driftPpm;           ///< EWMA of the pooled samples
+    bool driftValid;
+};
+
+RTC_DATA_ATTR RtcClockState rtcClock;
+
+void ensureState() {
+    if (rtcClock.magic != RTC_MAGIC) {
+        memset(&rtcClock, 0, sizeof(rtcClock));
+        rtcClock.magic = RTC_MAGIC;
+    }
+}
+
+void restartSample(const uint32_t epoch) {
+    rtcClock.sampleStartEpoch = epoch;
+    rtcClock.sampleErrorMs = 0;
+}
+
+// Fold the error found at this sync into the pooled sample, and the sample
+// into the estimate once it spans MIN_DRIFT_SAMPLE_SECONDS.
+void accountError(const uint32_t epoch, const int64_t errorMs) {
+    const uint32_t sinceLast = epoch - rtcClock.lastSyncEpoch;
+    const int64_t plausibleMs = static_cast<int64_t>(sinceLast) * WallClock::MAX_DRIFT_PPM / 1000 + 2000;
+    if (epoch <= rtcClock.lastSyncEpoch || errorMs > plausibleMs || errorMs < -plausibleMs) {
+        // Server clock stepped or ours was reset: not drift.
+        restartSample(epoch);
+        return;
+    }
+
+    rtcClock.sampleErrorMs += static_cast<int32_t>(errorMs);
+    const uint32_t pooled = epoch - rtcClock.sampleStartEpoch;
+    if (pooled < WallClock::MIN_DRIFT_SAMPLE_SECONDS) {
+        return;
+    }
+
+    // ms per s x 1000 = ppm
+    const int32_t sample = static_cast<int32_t>(static_cast<int64_t>(rtcClock.sampleErrorMs) * 1000 / pooled);
+    if (sample >= -WallClock::MAX_DRIFT_PPM && sample <= WallClock::MAX_DRIFT_PPM) {
+        rtcClock.driftPpm = rtcClock.driftValid ? rtcClock.driftPpm + (sample - rtcClock.driftPpm) / 4 : sample;
+        rtcClock.driftValid = true;
+    }
+    restartSample(epoch);
+}
+
+int monthFromAbbrev(const char* mon) {
+    static const char* const MONTHS[] = {"Jan", "Feb", "Mar", "Apr", "May", "Jun",
+                                         "Jul", "Aug", "Sep", "Oct", "Nov", "Dec"};
+    for (int i = 0; i < 12; ++i) {
+        if (strncmp(mon, MONTHS[i], 3) == 0) {
+            return i + 1;
+        }
+    }
+    return 0;
+}
+
+// Days since 1970-01-01 for a proleptic Gregorian date (Howard Hinnant's algorithm).
+int64_t daysFromCivil(int y, const unsigned m, const unsigned d) {
+    y -= m <= 2;
+    const int era = (y >= 0 ? y : y - 399) / 400;
+    const unsigned yoe = static_cast<unsigned>(y - era * 400);
+    const unsigned doy = (153 * (m + (m > 2 ? -3 : 9)) + 2) / 5 + d - 1;
+    const unsigned doe = yoe * 365 + yoe / 4 - yoe / 100 + doy;
+    return static_cast<int64_t>(era) * 146097 + static_cast<int64_t>(doe) - 719468;
+}
+
+}  // namespace
+
+time_t WallClock::parseHttpDate(const char* httpDate) {
+    if (httpDate == nullptr) {
+        return 0;
+    }
+
+    char weekday[4] = {0};
+    char mon[4] = {0};
+    int day = 0;
+    int year = 0;
+    int hour = 0;
+    int minute = 0;
+    int second = 0;
+    const int n = sscanf(httpDate, "%3s, %d %3s %d %d:%d:%d", weekday, &day, mon, &year, &hour, &minute, &second);
+    if (n != 7) {
+        return 0;
+    }
+
+    const int month = monthFromAbbrev(mon);
+    if (month == 0 || day < 1 || day > 31 || year < 1970 || hour > 23 || minute > 59 || second > 60) {
+        return 0;
+    }
+
+    const int64_t days = daysFromCivil(year, static_cast<unsigned>(month), static_cast<unsigned>(day));
+    return static_cast<time_t>(days * 86400 + hour * 3600 + minute * 60 + second);
+}
+
+bool WallClock::setFromHttpDate(const char* httpDate) {
+    const time_t epoch = parseHttpDate(httpDate);
+    if (epoch < MIN_VALID_EPOCH) {
+        return false;
+    }
+    ensureState();
+
+    // The header truncates to whole seconds: on average the server is half a second further on.
+    const int64_t serverMs = static_cast<int64_t>(epoch) * 1000 + 500;
+    struct timeval before = {};
+    gettimeofday(&before, nullptr);
+    const uint32_t syncEpoch = static_cast<uint32_t>(epoch);
+    if (before.tv_sec >= MIN_VALID_EPOCH && rtcClock.lastSyncEpoch != 0) {
+        const int64_t errorMs = static_cast<int64_t>(before.tv_sec) * 1000 + before.tv_usec / 1000 - serverMs;
+        accountError(syncEpoch, errorMs);
+        Telemetry::record(Telemetry::Event::CLOCK_SYNC, static_cast<int32_t>(errorMs), rtcClock.driftPpm,
+                          static_cast<int32_t>(syncEpoch - rtcClock.lastSyncEpoch));
+    } else {
+        restartSample(syncEpoch);
+    }
+
+    struct timeval tv = {};
+    tv.tv_sec = epoch;
+    tv.tv_usec = 500000;
+    settimeofday(&tv, nullptr);
+    rtcClock.lastSyncEpoch = syncEpoch;
+    return true;
+}
+
+time_t WallClock::now() {
+    const time_t t = time(nullptr);
+    if (t < MIN_VALID_EPOCH) {
+        return 0;
+    }
+    ensureState();
+    if (!rtcClock.driftValid || rtcClock.lastSyncEpoch == 0 || t <= static_cast<time_t>(rtcClock.lastSyncEpoch)) {
+        return t;
+    }
+    const int64_t since = static_cast<int64_t>(t) - rtcClock.lastSyncEpoch;
+    return static_cast<time_t>(t - since * rtcClock.driftPpm / 1000000);
+}
+
+uint64_t WallClock::sleepTimerUs(const uint64_t seconds) {
+    const int64_t us = static_cast<int64_t>(seconds * 1000000ULL);
+    ensureState();
+    if (!rtcClock.driftValid) {
+        return static_cast<uint64_t>(us);
+    }
+    // A fast clock counts the interval off early, so ask for proportionally more.
+    return static_cast<uint64_t>(us + us / 1000000 * rtcClock.driftPpm);
+}
+
+int32_t WallClock::driftPpm() {
+    ensureState();
+    return rtcClock.driftValid ? rtcClock.driftPpm : 0;
+}
@@ -0,0 +1,57 @@
+#pragma once
+
+#include <Arduino.h>
+#include <time.h>
+
+/**
+ * @brief Wall-clock time taken from the server's HTTP Date header
+ *
+ * The ESP32 keeps system time running through deep sleep on the RTC slow
+ * clock, so setting it once is enough for later wakes, even offline ones.
+ *
+ * The slow clock is only calibrated to within a fraction of a percent, so
+ * each sync also measures how far system time ran ahead of or behind the
+ * server since the previous ones. The resulting drift estimate lives in RTC
+ * memory. now() is corrected by it between syncs, and sleepTimerUs() scales
+ * sleep requests so a wake lands at the intended wall time.
+ */
+class WallClock {
+public:
+    /**
+     * @brief Set system time from an RFC 7231 IMF-fixdate string
+     *
+     * Example: "Sun, 06 Nov 1994 08:49:37 GMT"
+     *
+     * @return true if the date parsed and the clock was set
+     */
+    static bool setFromHttpDate(const char* httpDate);
+
+    /**
+     * @brief Parse an RFC 7231 IMF-fixdate string into a UTC epoch
+     *
+     * @return Seconds since 1970-01-01 UTC, or 0 if the string is malformed
+     */
+    static time_t parseHttpDate(const char* httpDate);
+
+    /**
+     * @brief Current UTC epoch, or 0 if the clock was never set
+     *
+     * Corrected for the estimated drift since the last sync.
+     */
+    static time_t now();
+
+    /**
+     * @brief Sleep timer duration that lasts the given wall-clock seconds
+     */
+    static uint64_t sleepTimerUs(uint64_t seconds);
+
+    /**
+     * @brief Estimated slow-clock drift in ppm (positive = runs fast), 0 until measured
+     */
+    static int32_t driftPpm();
+
+    /// Syncs closer together than this are pooled before a drift sample is taken,
+    /// so the 1 s resolution of the Date header stays well under the error measured.
+    static constexpr uint32_t MIN_DRIFT_SAMPLE_SECONDS = 1800;
+    static constexpr int32_t MAX_DRIFT_PPM = 50000;
+};
@@ -0,0 +1,314 @@
+#include "WifiConnector.h"
+
+#include <WiFi.h>
+#include <esp_rom_crc.h>
+#include <freertos/FreeRTOS.h>
+#include <freertos/event_groups.h>
+
+#include <string.h>
+
+#include <algorithm>
+
+#include "EnergyMeter.h"
+#include "WakeBudget.h"
+
+namespace {
+
+constexpr EventBits_t BIT_GOT_IP = BIT0;
+constexpr EventBits_t BIT_REJECTED = BIT1;  ///< AP missing or credentials refused
+
+constexpr uint32_t RTC_MAGIC = 0x57494649;  // "WIFI"
+
+struct Profile {
+    char ssid[33];
+    char password[65];
+};
+
+// The network that last handed out an address, kept across deep sleep.
+struct RtcLastGood {
+    uint32_t magic;
+    uint32_t ssidCrc;
+    uint8_t bssid[6];
+    uint8_t channel;
+};
+
+struct Candidate {
+    uint8_t profile;
+    uint8_t bssid[6];
+    uint8_t channel;
+};
+
+RTC_DATA_ATTR RtcLastGood rtcLastGood;
+
+EventGroupHandle_t wifiEvents = nullptr;
+bool started = false;
+bool waitFailed = false;  ///< waitConnected() gave up; the next start() begins again
+Profile profiles[TrmnlConfig::MAX_WIFI_PROFILES];
+size_t profileCount = 0;
+size_t current = 0;
+bool pinned = false;  ///< Current attempt is locked to pinnedBssid
+uint8_t pinnedBssid[6] = {0};
+uint8_t attemptCount = 0;
+uint32_t startedAtMs = 0;
+uint32_t attemptAtMs = 0;
+volatile uint32_t gotIpAtMs = 0;
+
+void onWifiEvent(arduino_event_id_t event, arduino_event_info_t info) {
+    if (event == ARDUINO_EVENT_WIFI_STA_GOT_IP) {
+        gotIpAtMs = millis();
+        xEventGroupSetBits(wifiEvents, BIT_GOT_IP);
+    } else if (event == ARDUINO_EVENT_WIFI_STA_DISCONNECTED) {
+        xEventGroupClearBits(wifiEvents, BIT_GOT_IP);
+        const uint8_t reason = info.wifi_sta_disconnected.reason;
+        if (reason == WIFI_REASON_NO_AP_FOUND || reason == WIFI_REASON_AUTH_FAIL || reason == WIFI_REASON_ASSOC_FAIL ||
+            reason == WIFI_REASON_HANDSHAKE_TIMEOUT || reason == WIFI_REASON_4WAY_HANDSHAKE_TIMEOUT) {
+            xEventGroupSetBits(wifiEvents, BIT_REJECTED);
+        }
+    } else if (event == ARDUINO_EVENT_WIFI_STA_LOST_IP) {
+        xEventGroupClearBits(wifiEvents, BIT_GOT_IP);
+    }
+}
+
+uint32_t ssidCrc(const char* ssid) {
+    return esp_rom_crc32_le(0, reinterpret_cast<const uint8_t*>(ssid), strlen(ssid));
+}
+
+// Index of the remembered profile, or -1 if there is none or it was removed.
+int lastGoodProfile() {
+    if (rtcLastGood.magic != RTC_MAGIC) {
+        return -1;
+    }
+    for (size_t i = 0; i < profileCount; ++i) {
+        if (ssidCrc(profiles[i].ssid) == rtcLastGood.ssidCrc) {
+            return static_cast<int>(i);
+        }
+    }
+    return -1;
+}
+
+void rememberConnection() {
+    const uint8_t* bssid = WiFi.BSSID();
+    if (bssid == nullptr) {
+        return;
+    }
+    rtcLastGood.magic = RTC_MAGIC;
+    rtcLastGood.ssidCrc = ssidCrc(profiles[current].ssid);
+    memcpy(rtcLastGood.bssid, bssid, sizeof(rtcLastGood.bssid));
+    rtcLastGood.channel = static_cast<uint8_t>(WiFi.channel());
+}
+
+// bssid may be null to let the driver scan for the SSID itself.
+void beginAttempt(const size_t profile, const uint8_t* bssid, const uint8_t channel) {
+    xEventGroupClearBits(wifiEvents, BIT_GOT_IP | BIT_REJECTED);
+    current = profile;
+    pinned = bssid != nullptr;
+    if (pinned) {
+        memcpy(pinnedBssid, bssid, sizeof(pinnedBssid));
+    }
+    attemptCount++;
+    attemptAtMs = millis();
+    gotIpAtMs = 0;
+
+    Serial.printf("WiFi: joining %s%s\n", profiles[profile].ssid, pinned ? " (known BSSID)" : "");
+    EnergyMeter::radioOn();
+    WiFi.mode(WIFI_STA);
+    WiFi.persistent(false);
+    WiFi.begin(profiles[profile].ssid, profiles[profile].password, pinned ? channel : 0, bssid);
+}
+
+uint32_t elapsedMs() {
+    return millis() - startedAtMs;
+}
+
+// Wait for the running attempt. Unless it is the last one, give up early when
+// the AP is missing or refuses us, and after PROFILE_CONNECT_MS at most. No
+// attempt outlives the wake budget.
+bool waitAttempt(const uint32_t timeoutMs, const bool last) {
+    uint32_t endMs = timeoutMs;
+    if (!last) {
+        endMs = std::min(endMs, (attemptAtMs - startedAtMs) + WifiConnector::PROFILE_CONNECT_MS);
+    }
+    const uint32_t now = elapsedMs();
+    if (endMs > now && endMs - now > WakeBudget::remainingMs()) {
+        endMs = now + WakeBudget::remainingMs();
+    }
+
+    for (;;) {
+        const uint32_t elapsed = elapsedMs();
+        const uint32_t remaining = (elapsed < endMs) ? (endMs - elapsed) : 0;
+        const EventBits_t bits =
+            xEventGroupWaitBits(wifiEvents, BIT_GOT_IP | BIT_REJECTED, pdFALSE, pdFALSE, pdMS_TO_TICKS(remaining));
+        if ((bits & BIT_GOT_IP) != 0 || remaining == 0) {
+            return WiFi.status() == WL_CONNECTED;
+        }
+        if ((bits & BIT_REJECTED) != 0) {
+            if (!last) {
+                return false;
+            }
+            // The core keeps retrying; the last candidate has nothing to lose.
+            xEventGroupClearBits(wifiEvents, BIT_REJECTED);
+            continue;
+        }
+        return WiFi.status() == WL_CONNECTED;
+    }
+}
+
+// One scan, then every profile in range, in config order, on its strongest
+// BSSID. The attempt that already failed is left out.
+size_t scanCandidates(Candidate (&out)[TrmnlConfig::MAX_WIFI_PROFILES]) {
+    const size_t failed = current;
+    const bool failedPinned = pinned;
+
+    // The driver refuses to scan while it is still trying to associate.
+    WiFi.disconnect();
+    const int16_t found = WiFi.scanNetworks(false, false, false, WifiConnector::SCAN_MS_PER_CHANNEL);
+    Serial.printf("WiFi: scan found %d networks in %u ms\n", found, elapsedMs());
+
+    size_t count = 0;
+    for (size_t p = 0; p < profileCount; ++p) {
+        int best = -1;
+        for (int16_t i = 0; i < found; ++i) {
+            if (strcmp(WiFi.SSID(i).c_str(), profiles[p].ssid) == 0 && (best < 0 || WiFi.RSSI(i) > WiFi.RSSI(best))) {
+                best = i;
+            }
+        }
+        if (best < 0) {
+            continue;
+        }
+        const uint8_t* bssid = WiFi.BSSID(best);
+        if (p == failed && (!failedPinned || memcmp(bssid, pinnedBssid, sizeof(pinnedBssid)) == 0)) {
+            continue;
+        }
+        Candidate& candidate = out[count++];
+        candidate.profile = static_cast<uint8_t>(p);
+        memcpy(candidate.bssid, bssid, sizeof(candidate.bssid));
+        candidate.channel = static_cast<uint8_t>(WiFi.channel(best));
+    }
+    WiFi.scanDelete();
+    return count;
+}
+
+bool sameProfiles(const TrmnlConfig& config) {
+    if (config.wifiProfiles.size() != profileCount) {
+        return false;
+    }
+    for (size_t i = 0; i < profileCount; ++i) {
+        if (strcmp(profiles[i].ssid, config.wifiProfiles[i].ssid.c_str()) != 0 ||
+            strcmp(profiles[i].password, config.wifiProfiles[i].password.c_str()) != 0) {
+            return false;
+        }
+    }
+    return true;
+}
+
+}  // namespace
+
+void WifiConnector::start(const TrmnlConfig& config) {
+    if (started && !waitFailed && sameProfiles(config)) {
+        return;
+    }
+    if (config.wifiProfiles.empty()) {
+        return;
+    }
+
+    if (wifiEvents == nullptr) {
+        wifiEvents = xEventGroupCreate();
+        WiFi.onEvent(onWifiEvent);
+    }
+    if (started) {
+        WiFi.disconnect();
+    }
+
+    profileCount = config.wifiProfiles.size();
+    if (profileCount > TrmnlConfig::MAX_WIFI_PROFILES) {
+        profileCount = TrmnlConfig::MAX_WIFI_PROFILES;
+    }
+    for (size_t i = 0; i < profileCount; ++i) {
+        strlcpy(profiles[i].ssid, config.wifiProfiles[i].ssid.c_str(), sizeof(profiles[i].ssid));
+        strlcpy(profiles[i].password, config.wifiProfiles[i].password.c_str(), sizeof(profiles[i].password));
+    }
+    started = true;
+    waitFailed = false;
+    startedAtMs = millis();
+    attemptCount = 0;
+
+    const int last = lastGoodProfile();
+    if (last >= 0) {
+        beginAttempt(static_cast<size_t>(last), rtcLastGood.bssid, rtcLastGood.channel);
+    } else {
+        beginAttempt(0, nullptr, 0);
+    }
+}
+
+bool WifiConnector::waitConnected(const uint32_t timeoutMs) {
+    if (!started) {
+        return false;
+    }
+
+    // A single profile with nothing cached has no fallback: it gets the whole budget.
+    const bool onlyChoice = profileCount == 1 && !pinned;
+    if (waitAttempt(timeoutMs, onlyChoice)) {
+        rememberConnection();
+        return true;
+    }
+    if (pinned) {
+        // The remembered AP did not take us back; don't insist on it next wake.
+        rtcLastGood.magic = 0;
+    }
+    if (onlyChoice || elapsedMs() >= timeoutMs || WakeBudget::expired()) {
+        waitFailed = true;
+        return false;
+    }
+
+    Candidate candidates[TrmnlConfig::MAX_WIFI_PROFILES];
+    const size_t count = scanCandidates(candidates);
+    if (count == 0) {
+        // Nothing else in range: give the same network the rest of the time
+        // and let the driver pick the AP, as a single profile always did.
+        beginAttempt(current, nullptr, 0);
+        if (waitAttempt(timeoutMs, true)) {
+            rememberConnection();
+            return true;
+        }
+        waitFailed = true;
+        return false;
+    }
+    for (size_t i = 0; i < count && elapsedMs() < timeoutMs && !WakeBudget::expired(); ++i) {
+        beginAttempt(candidates[i].profile, candidates[i].bssid, candidates[i].channel);
+        if (waitAttempt(timeoutMs, i + 1 == count)) {
+            rememberConnection();
+            return true;
+        }
+        WiFi.disconnect();
+    }
+    waitFailed = true;
+    return false;
+}
+
+void WifiConnector::stop() {
+    if (!started) {
+        return;
+    }
+    WiFi.disconnect(true);
+    WiFi.mode(WIFI_OFF);
+    xEventGroupClearBits(wifiEvents, BIT_GOT_IP | BIT_REJECTED);
+    started = false;
+    profileCount = 0;
+    EnergyMeter::radioOff();
+}
+
+bool WifiConnector::isStarted() {
+    return started;
+}
+
+uint32_t WifiConnector::connectDurationMs() {
+    return (gotIpAtMs != 0) ? (gotIpAtMs - startedAtMs) : 0;
+}
+
+const char* WifiConnector::ssid() {
+    return (profileCount > 0) ? profiles[current].ssid : "";
+}
+
+uint8_t WifiConnector::attempts() {
+    return attemptCount;
+}
@@ -0,0 +1,83 @@
+#pragma once
+
+#include <Arduino.h>
+
+#include "ConfigLoader.h"
+
+/**
+ * @brief Asynchronous WiFi association for the boot pipeline
+ *
+ * Association and DHCP run inside the WiFi driver task, so start() only kicks
+ * them off and returns. waitConnected() is the join point: it blocks on an
+ * event group that the GOT_IP / DISCONNECTED callbacks update, instead of
+ * polling WiFi.status().
+ *
+ * On warm wakes the credentials come from ConfigLoader's RTC snapshot, so the
+ * radio can come up before the SD card is mounted.
+ *
+ * With several wifi profiles, the network that last handed out an address is
+ * kept in RTC memory with its BSSID and channel. start() joins it directly,
+ * skipping the scan. If that fails, waitConnected() runs one scan and tries
+ * the other profiles that are in range, in config order. If none is, the
+ * failed profile is tried again without a pinned BSSID. Each attempt but the
+ * last gets at most PROFILE_CONNECT_MS, and the last gets whatever is left of
+ * the overall budget. No attempt runs past the WakeBudget deadline. A
+ * remembered network that fails is forgotten, so the next wake starts fresh.
+ */
+class WifiConnector {
+public:
+    static constexpr uint32_t PROFILE_CONNECT_MS = 6000;
+    static constexpr uint32_t SCAN_MS_PER_CHANNEL = 120;
+
+    /**
+     * @brief Start association with the preferred configured network
+     *
+     * That is the last-good profile if it is still configured, otherwise the
+     * first. No-op if association with the same profile list is already
+     * running, unless waitConnected() gave up on it: a retry then starts over
+     * with a fresh timeout.
+     *
+     * @param config Loaded TrmnlConfig
+     */
+    static void start(const TrmnlConfig& config);
+
+    /**
+     * @brief Join point: wait until an IP address has been obtained
+     *
+     * Falls back to the other profiles as described above. The timeout is
+     * measured from the moment association started, so time spent on SD,
+     * config and display init is not charged twice.
+     *
+     * @param timeoutMs Association budget in milliseconds, for all profiles
+     * @return true if connected
+     */
+    static bool waitConnected(uint32_t timeoutMs);
+
+    /**
+     * @brief Disconnect and power the radio down for the rest of the wake
+     *
+     * Called once the network work is done, so the remaining idle waits can
+     * use light sleep.
+     */
+    static void stop();
+
+    /**
+     * @brief Whether association has been started on this wake
+     */
+    static bool isStarted();
+
+    /**
+     * @brief Milliseconds from start() to GOT_IP, or 0 if not connected yet
+     */
+    static uint32_t connectDurationMs();
+
+    /**
+     * @brief SSID of the profile joined, or of the last one tried
+     */
+    static const char* ssid();
+
+    /**
+     * @brief Associations begun on this wake, including the one from start()
+     */
+    static uint8_t attempts();
+};
@@ -10,6 +10,21 @@
 #include "ApiClient.h"
 #include "ButtonHandler.h"
 #include "TextDraw.h"
+#include "WifiConnector.h"
+#include "DnsCache.h"
+#include "EnergyMeter.h"
+#include "HeapMonitor.h"
+#include "InputEvents.h"
+#include "LogUploader.h"
+#include "OtaUpdater.h"
+#include "RefreshPlanner.h"
+#include "ScreenBrowser.h"
+#include "ScreenCache.h"
+#include "SdBus.h"
+#include "StatusBar.h"
+#include "Telemetry.h"
+#include "WakeBudget.h"
+#include "WallClock.h"
 
 // SDK Libraries
 #include <EInkDisplay.h>
@@ -36,7 +51,10 @@ ButtonHandler buttonHandler(inputManager);
 #define TRMNL_MIN_UPTIME_BEFORE_SLEEP_MS 12000
 #endif
 
+#define WIFI_CONNECT_TIMEOUT_MS 20000
+
 static void waitForSerialBrief() {
+    EnergyMeter::Scope idle(EnergyMeter::State::IDLE);
     const uint32_t start = millis();
     while (!Serial && (millis() - start) < 2000) {
         delay(10);
@@ -46,14 +64,17 @@ static void waitForSerialBrief() {
 static void ensureUptimeBeforeSleep() {
     const uint32_t now = millis();
     if (now < TRMNL_MIN_UPTIME_BEFORE_SLEEP_MS) {
-        delay(TRMNL_MIN_UPTIME_BEFORE_SLEEP_MS - now);
+        EnergyMeter::Scope idle(EnergyMeter::State::IDLE);
+        InputEvents::idle(TRMNL_MIN_UPTIME_BEFORE_SLEEP_MS - now);
     }
 }
 
 static void holdUsbWindow(const char* reason) {
     (void)reason;
-    // Give a window to attach serial / reflash before sleeping.
-    delay(TRMNL_SAFE_BOOT_MS);
+    // Give a window to attach serial / reflash before sleeping. With a host
+    // already attached this stays awake; otherwise it light-sleeps.
+    EnergyMeter::Scope idle(EnergyMeter::State::IDLE);
+    InputEvents::idle(TRMNL_SAFE_BOOT_MS);
 }
 
 static void enterDeepSleep(uint64_t sleepSeconds) {
@@ -63,6 +84,7 @@ static void enterDeepSleep(uint64_t sleepSeconds) {
     return;
 #else
     ensureUptimeBeforeSleep();
+    EnergyMeter::commit(static_cast<uint32_t>(sleepSeconds), batteryMonitor.readVolts());
 
     // Configure GPIO3 as input with pull-up to avoid floating level.
     gpio_config_t io_conf = {
@@ -75,7 +97,7 @@ static void enterDeepSleep(uint64_t sleepSeconds) {
     gpio_config(&io_conf);
 
     // Configure wake sources
-    esp_sleep_enable_timer_wakeup(sleepSeconds * 1000000ULL);
+    esp_sleep_enable_timer_wakeup(WallClock::sleepTimerUs(sleepSeconds));
     esp_deep_sleep_enable_gpio_wakeup((1ULL << WAKE_PIN_POWER), ESP_GPIO_WAKEUP_GPIO_LOW);
     
     Serial.printf("Entering deep sleep for %llu seconds...\n", sleepSeconds);
@@ -98,12 +120,67 @@ static void returnToCrossPoint() {
     esp_restart();
 }
 
+static void sleepUntilNextRefresh(const TrmnlConfig& config, const uint32_t serverRate) {
+    const RefreshPlan plan = RefreshPlanner::plan(serverRate, batteryMonitor.readVolts(), WallClock::now(), config);
+    Serial.printf("Refresh plan: server %u s, battery x%.2f%s -> %u s\n", plan.serverSeconds, plan.batteryFactor,
+                  plan.quietHours ? ", quiet hours" : "", plan.seconds);
+    if (plan.aligned) {
+        Serial.printf("Wake aligned to %u s boundaries, %u s early; clock drift %d ppm\n", config.wakeAlignSeconds,
+                      plan.leadSeconds, WallClock::driftPpm());
+    }
+    Telemetry::record(Telemetry::Event::SLEEP, static_cast<int32_t>(plan.seconds),
+                      static_cast<int32_t>(plan.batteryFactor * 100.0f), plan.quietHours ? 1 : 0);
+    enterDeepSleep(plan.seconds);
+}
+
+// The network steps ran out of wake budget. Leave the last image on the panel
+// and retry after a backoff instead of waiting awake on an error screen. Only
+// the quiet-hours step of RefreshPlanner applies: battery stretching and wake
+// alignment would reshape the backoff, and the planner's last interval is what
+// Refresh-Rate reports.
+static void sleepAfterBudgetExhausted(const TrmnlConfig& config) {
+    StatusBar::recordFailure(false);
+    const uint16_t failed = StatusBar::failedWakes();
+    uint32_t backoff = WakeBudget::backoffSeconds(failed, config);
+    Telemetry::record(Telemetry::Event::WAKE_BUDGET, static_cast<int32_t>(WakeBudget::budgetMs()), failed,
+                      static_cast<int32_t>(backoff));
+    const bool quiet = RefreshPlanner::deferPastQuietHours(backoff, WallClock::now(), config);
+    Serial.printf("Wake budget of %u ms exhausted (%u failed wakes), retrying in %u s%s\n", WakeBudget::budgetMs(),
+                  failed, backoff, quiet ? " (after quiet hours)" : "");
+    WifiConnector::stop();
+    if (ApiClient::savePartialImage()) {
+        Serial.println("Partial image saved to SD for the next wake");
+    }
+    Telemetry::record(Telemetry::Event::SLEEP, static_cast<int32_t>(backoff), 100, quiet ? 1 : 0);
+    enterDeepSleep(backoff);
+}
+
+static void applyFirmwareUpdate(const TrmnlConfig& config, const FirmwareUpdate& firmware) {
+    if (!firmware.available) {
+        return;
+    }
+
+    Serial.printf("Firmware update offered: %s\n", firmware.url);
+    WakeBudget::end();
+    const OtaResult result = OtaUpdater::update(firmware, config);
+    Serial.printf("Firmware update: %s\n", OtaUpdater::resultToString(result));
+
+    if (result == OtaResult::SUCCESS) {
+        Serial.flush();
+        esp_restart();
+    }
+    if (result != OtaResult::SKIPPED_APP_MODE) {
+        LogUploader::enqueue(static_cast<int32_t>(result), OtaUpdater::resultToString(result));
+    }
+}
+
 enum class MenuAction { START, EXIT, RETRY };
 
 static MenuAction showBootMenu(const TrmnlConfig& config, const ConfigResult& configResult, const bool allowAutoStart) {
     (void)config;
 
     display.clearScreen(0xFF);
+    StatusBar::screenReplaced();
     TextDraw::drawCenteredString(display, "TRMNL DASHBOARD", 80);
 
     const bool cfgOk = (configResult.error == ConfigError::SUCCESS);
@@ -121,11 +198,22 @@ static MenuAction showBootMenu(const TrmnlConfig& config, const ConfigResult& co
         TextDraw::drawCenteredString(display, "BACK: EXIT", 250);
     }
 
-    display.displayBuffer(EInkDisplay::FAST_REFRESH, false);
+    {
+        EnergyMeter::Scope busy(EnergyMeter::State::DISPLAY);
+        display.displayBuffer(EInkDisplay::FAST_REFRESH, false);
+    }
 
+    EnergyMeter::Scope idle(EnergyMeter::State::IDLE);
     const uint32_t start = millis();
+    const uint32_t autoStartMs = (cfgOk && allowAutoStart) ? 8000 : UINT32_MAX;
     while (true) {
-        inputManager.update();
+        const uint32_t elapsed = millis() - start;
+        if (elapsed >= autoStartMs) {
+            return MenuAction::START;
+        }
+        if (!InputEvents::waitForPress(inputManager, autoStartMs - elapsed)) {
+            continue;
+        }
 
         if (inputManager.wasPressed(InputManager::BTN_BACK)) {
             return MenuAction::EXIT;
@@ -133,92 +221,205 @@ static MenuAction showBootMenu(const TrmnlConfig& config, const ConfigResult& co
         if (inputManager.wasPressed(InputManager::BTN_CONFIRM)) {
             return cfgOk ? MenuAction::START : MenuAction::RETRY;
         }
-
-        if (cfgOk && allowAutoStart && (millis() - start) >= 8000) {
-            return MenuAction::START;
-        }
-
-        delay(20);
     }
 }
 
 static bool connectWifiOrShowError(const TrmnlConfig& config) {
-    Serial.printf("Connecting to WiFi: %s\n", config.wifiSsid.c_str());
-    WiFi.mode(WIFI_STA);
-    WiFi.persistent(false);
-    WiFi.begin(config.wifiSsid.c_str(), config.wifiPassword.c_str());
-
-    const uint32_t startAttempt = millis();
-    while (WiFi.status() != WL_CONNECTED && (millis() - startAttempt) < 20000) {
-        delay(250);
-    }
+    // Usually already running since setup(); this only (re)starts it if the config changed.
+    WifiConnector::start(config);
+    Serial.printf("Connecting to WiFi: %s (%u networks configured)\n", WifiConnector::ssid(),
+                  static_cast<unsigned>(config.wifiProfiles.size()));
 
-    if (WiFi.status() != WL_CONNECTED) {
+    if (!WifiConnector::waitConnected(WIFI_CONNECT_TIMEOUT_MS)) {
         Serial.println("WiFi Connection Failed!");
-        ErrorDisplay::showWiFiError(display, config.wifiSsid.c_str());
+        Telemetry::record(Telemetry::Event::WIFI_FAILED, static_cast<int32_t>(WiFi.status()), WifiConnector::attempts());
+        LogUploader::enqueue(static_cast<int32_t>(WiFi.status()), "WiFi connection failed");
+        if (WakeBudget::expired()) {
+            sleepAfterBudgetExhausted(config);
+            return false;
+        }
+        StatusBar::recordFailure();
+        ErrorDisplay::showWiFiError(display, WifiConnector::ssid());
+        // Light sleep needs the radio off; a retry from the menu starts it again.
+        WifiConnector::stop();
         holdUsbWindow("wifi_error");
         return false;
     }
 
+    Serial.printf("WiFi connected to %s in %u ms (%u attempts)\n", WifiConnector::ssid(),
+                  WifiConnector::connectDurationMs(), WifiConnector::attempts());
+    HeapMonitor::mark(HeapMonitor::Stage::WIFI);
+    Telemetry::record(Telemetry::Event::WIFI_CONNECTED, static_cast<int32_t>(WifiConnector::connectDurationMs()),
+                      WiFi.RSSI(), WifiConnector::attempts());
     return true;
 }
 
-static void runOnce(const TrmnlConfig& config) {
+// budgetStartMs: millis() the wake budget counts from. scheduled: first run of
+// a timer wake, which came straight here from the deep sleep timer.
+static void runOnce(const TrmnlConfig& config, const uint32_t budgetStartMs, const bool scheduled) {
+    WakeBudget::begin(config, batteryMonitor.readVolts(), budgetStartMs);
     if (!connectWifiOrShowError(config)) {
         return;
     }
 
     Serial.println("Fetching display data...");
     DisplayFetchResult fetchResult = ApiClient::fetchDisplay(config);
+    DnsCache::recordTelemetry();
 
     if (fetchResult.result.error != ApiError::SUCCESS) {
         Serial.printf("API Error: %s\n", fetchResult.result.errorMessage.c_str());
+        LogUploader::enqueue(static_cast<int32_t>(fetchResult.result.error), fetchResult.result.errorMessage.c_str());
+        if (WakeBudget::expired()) {
+            sleepAfterBudgetExhausted(config);
+            return;
+        }
+        StatusBar::recordFailure();
         ErrorDisplay::showApiError(display, fetchResult.result.httpStatus);
+        WifiConnector::stop();
         holdUsbWindow("api_error");
         return;
     }
 
+    StatusBar::recordSuccess();
     if (fetchResult.trmnlStatus == TrmnlStatus::NO_UPDATE) {
         Serial.println("No update needed (Status 202)");
+        if (StatusBar::refresh(display, config, batteryMonitor)) {
+            Serial.println("Status bar refreshed");
+        }
+        applyFirmwareUpdate(config, fetchResult.firmware);
+        WifiConnector::stop();
         // In release mode, sleep until next refresh; in dev, return to menu.
         holdUsbWindow("no_update");
-        enterDeepSleep(fetchResult.refreshRate);
+        sleepUntilNextRefresh(config, fetchResult.refreshRate);
         return;
     }
 
     Serial.println("Rendering image...");
-    ImageRenderer::BmpResult renderResult = ImageRenderer::renderBmp(fetchResult.imageData.data(), fetchResult.imageData.size(), display);
+    const uint32_t decodeStart = millis();
+    uint32_t frameHash = 0;
+    ImageRenderer::BmpResult renderResult =
+        ImageRenderer::decode(fetchResult.imageData, fetchResult.imageSize, display, &frameHash);
+    // Servers often hand out a new image URL for the same pixels; the panel already shows them.
+    const bool unchanged = renderResult == ImageRenderer::BmpResult::SUCCESS && StatusBar::showsFrame(frameHash);
+    if (unchanged) {
+        StatusBar::recordUnchangedFrame();
+        Serial.printf("Image unchanged (frame hash %08x), panel refresh skipped\n", frameHash);
+        Telemetry::record(Telemetry::Event::FRAME_UNCHANGED, static_cast<int32_t>(frameHash),
+                          StatusBar::unchangedInRow(), static_cast<int32_t>(StatusBar::unchangedTotal()));
+        if (StatusBar::refresh(display, config, batteryMonitor)) {
+            Serial.println("Status bar refreshed");
+        }
+    } else if (renderResult == ImageRenderer::BmpResult::SUCCESS) {
+        StatusBar::compose(display, config, batteryMonitor, frameHash);
+        renderResult = ImageRenderer::showDecoded(display, decodeStart);
+    }
     if (renderResult != ImageRenderer::BmpResult::SUCCESS) {
         Serial.printf("Render Error Code: %d\n", static_cast<int>(renderResult));
+        LogUploader::enqueue(static_cast<int32_t>(renderResult), "Image render failed");
+        StatusBar::recordFailure();
         ErrorDisplay::showGenericError(display, "Image Render Failed");
+        WifiConnector::stop();
         holdUsbWindow("render_error");
         return;
     }
+    HeapMonitor::mark(HeapMonitor::Stage::RENDER);
+    // Anything but the first run of a timer wake would charge menu time to the wake latency.
+    if (scheduled && !unchanged) {
+        RefreshPlanner::recordWakeLatency(millis());
+    }
+    if (!unchanged && config.screenCacheSize > 0) {
+        SdBus::Scope sd;
+        if (!ScreenCache::save(display.getFrameBuffer(), config.screenCacheSize)) {
+            Serial.println("Screen cache save failed");
+        }
+    }
 
-    Serial.printf("Update complete. Sleeping for %u seconds.\n", fetchResult.refreshRate);
+    Serial.println("Update complete.");
+    applyFirmwareUpdate(config, fetchResult.firmware);
+    WifiConnector::stop();
     holdUsbWindow("before_sleep");
-    enterDeepSleep(fetchResult.refreshRate);
+    sleepUntilNextRefresh(config, fetchResult.refreshRate);
 }
 
 void setup() {
+    EnergyMeter::begin();
+    Telemetry::begin();
+
+    // On warm wakes the config comes from the RTC snapshot and the radio starts
+    // associating before anything else; the serial wait, SD mount and panel
+    // init all overlap with it. The join point is WifiConnector::waitConnected()
+    // in runOnce(). A power-button wake with cached screens keeps the radio off
+    // while the user browses them.
+    const bool haveSnapshot = ConfigLoader::loadFromSnapshot();
+    const bool timerWake = esp_sleep_get_wakeup_cause() == ESP_SLEEP_WAKEUP_TIMER;
+    const bool buttonWake = esp_sleep_get_wakeup_cause() == ESP_SLEEP_WAKEUP_GPIO;
+    if (haveSnapshot && !(buttonWake && ConfigLoader::getConfig().screenCacheSize > 0)) {
+        WifiConnector::start(ConfigLoader::getConfig());
+    }
+    const bool wifiEarly = WifiConnector::isStarted();
+
     Serial.begin(115200);
     waitForSerialBrief();
     delay(250);
     Serial.println("\n=== CrossPoint X4 Terminal Starting ===");
+    Serial.printf("WiFi early start: %s\n", wifiEarly ? "yes" : "no");
+    if (Serial) {
+        EnergyMeter::dump(Serial);
+    }
+    HeapMonitor::mark(HeapMonitor::Stage::BOOT);
+    Telemetry::record(Telemetry::Event::BOOT, static_cast<int32_t>(esp_sleep_get_wakeup_cause()),
+                      static_cast<int32_t>(esp_reset_reason()), static_cast<int32_t>(batteryMonitor.readVolts() * 1000.0));
+    const esp_reset_reason_t resetReason = esp_reset_reason();
+    if (resetReason == ESP_RST_PANIC || resetReason == ESP_RST_INT_WDT || resetReason == ESP_RST_TASK_WDT ||
+        resetReason == ESP_RST_WDT || resetReason == ESP_RST_BROWNOUT) {
+        LogUploader::enqueue(static_cast<int32_t>(resetReason), "Abnormal reset before this wake");
+    }
 
+    // Timer wakes trust the snapshot and never touch SD unless the telemetry
+    // buffer needs draining. Any other wake mounts SD; load() only reparses
+    // the JSON if the file's size/mtime changed.
     // SD/config MUST be read before display.begin() because display.begin() sets SPI MISO=-1.
-    (void)SdMan.begin();
-    const ConfigResult configResult = ConfigLoader::load();
+    ConfigResult configResult;
+    const bool skipSd = haveSnapshot && timerWake && !Telemetry::needsFlush();
+    if (skipSd) {
+        configResult = ConfigResult(ConfigError::SUCCESS, "Config restored from RTC snapshot");
+    } else {
+        (void)SdMan.begin();
+        configResult = ConfigLoader::load();
+        if (!Telemetry::flush()) {
+            Serial.println("Telemetry flush failed");
+        }
+    }
+    Serial.printf("Config: %s\n", configResult.errorMessage.c_str());
+    Telemetry::record(Telemetry::Event::CONFIG, static_cast<int32_t>(configResult.error), skipSd ? 1 : 0);
+    HeapMonitor::mark(HeapMonitor::Stage::CONFIG);
     const TrmnlConfig& config = ConfigLoader::getConfig();
 
+    // Cold boot: start association as soon as credentials are known. On warm
+    // wakes this only restarts it if the config file changed the credentials.
+    const bool browse = buttonWake && configResult.error == ConfigError::SUCCESS && config.screenCacheSize > 0;
+    if (configResult.error == ConfigError::SUCCESS && !browse) {
+        WifiConnector::start(config);
+    }
+
     display.begin();
     inputManager.begin();
+    InputEvents::begin();
     ApiClient::setBatteryMonitor(&batteryMonitor);
 
+    if (browse) {
+        ScreenBrowser::run(display, inputManager, config);
+    }
+
     bool allowAutoStart = true;
+    // Timer wakes are unattended: go straight to the fetch and leave the
+    // dashboard on the panel, so the status strip can be patched in place and
+    // an unchanged image needs no refresh at all.
+    bool skipMenu = timerWake && configResult.error == ConfigError::SUCCESS;
 
     for (;;) {
-        const MenuAction action = showBootMenu(config, configResult, allowAutoStart);
+        const MenuAction action = skipMenu ? MenuAction::START : showBootMenu(config, configResult, allowAutoStart);
+        skipMenu = false;
         if (action == MenuAction::EXIT) {
             if (!config.standaloneMode) {
                 returnToCrossPoint();
@@ -238,7 +439,10 @@ void setup() {
             continue;
         }
 
-        runOnce(config);
+        // The first run of a timer wake charges boot and SD to the wake budget
+        // as well; a retry from the menu gets a fresh one.
+        const bool scheduled = timerWake && allowAutoStart;
+        runOnce(config, scheduled ? 0 : millis(), scheduled);
         // If we reached here, we didn't deep sleep (dev mode or error). Return to menu.
         holdUsbWindow("back_to_menu");
         allowAutoStart = false;
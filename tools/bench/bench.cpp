@@ -0,0 +1,108 @@
+// Host microbenchmarks for the firmware's hot paths that handle untrusted
+// server data. Build and run with tools/bench/bench.sh.
+
+#include <benchmark/benchmark.h>
+
+
+#include "ApiClient.h"
+#include "ApiResponseParser.h"
+#include "ImageRenderer.h"
+#include "TextDraw.h"
+#include "inputs.h"
+
+namespace {
+
+EInkDisplay display;
+
+void renderBmp(benchmark::State& state, const BenchInputs::BmpPattern pattern) {
+    const std::vector<uint8_t> bmp = BenchInputs::makeBmp(pattern);
+    for (auto _ : state) {
+        const auto result = ImageRenderer::render(bmp.data(), bmp.size(), display);
+        benchmark::DoNotOptimize(result);
+        benchmark::ClobberMemory();
+    }
+    state.SetBytesProcessed(static_cast<int64_t>(state.iterations()) * static_cast<int64_t>(bmp.size()));
+}
+
+void BM_RenderBmp_AllWhite(benchmark::State& state) {
+    renderBmp(state, BenchInputs::BmpPattern::ALL_WHITE);
+}
+void BM_RenderBmp_Dense(benchmark::State& state) {
+    renderBmp(state, BenchInputs::BmpPattern::DENSE);
+}
+void BM_RenderBmp_InvertedPalette(benchmark::State& state) {
+    renderBmp(state, BenchInputs::BmpPattern::INVERTED_PALETTE);
+}
+
+void BM_RenderFramebuffer(benchmark::State& state) {
+    const std::vector<uint8_t> fb = BenchInputs::makeFramebuffer();
+    for (auto _ : state) {
+        const auto result = ImageRenderer::render(fb.data(), fb.size(), display);
+        if (result != ImageRenderer::BmpResult::SUCCESS) {
+            state.SkipWithError("framebuffer rejected");
+            break;
+        }
+        benchmark::ClobberMemory();
+    }
+    state.SetBytesProcessed(static_cast<int64_t>(state.iterations()) * static_cast<int64_t>(fb.size()));
+}
+
+void BM_DrawChar(benchmark::State& state) {
+    char c = 32;
+    for (auto _ : state) {
+        TextDraw::drawChar(display, c, 396, 236);
+        c = c == 126 ? 32 : static_cast<char>(c + 1);
+        benchmark::ClobberMemory();
+    }
+}
+
+void BM_DrawChar_Clipped(benchmark::State& state) {
+    for (auto _ : state) {
+        TextDraw::drawChar(display, 'W', 796, 476);
+        benchmark::ClobberMemory();
+    }
+}
+
+void BM_DrawCenteredString(benchmark::State& state) {
+    for (auto _ : state) {
+        TextDraw::drawCenteredString(display, "CONFIRM: START", 200);
+        benchmark::ClobberMemory();
+    }
+}
+
+void parseJson(benchmark::State& state, const std::string& json) {
+    char imageUrl[MAX_URL_LENGTH];
+    for (auto _ : state) {
+        uint32_t refreshRate = 0;
+        TrmnlStatus status = TrmnlStatus::SUCCESS;
+        FirmwareUpdate firmware;
+        const ApiResult result = ApiResponseParser::parse(json.data(), json.size(), imageUrl, refreshRate, status, firmware);
+        if (result.error != ApiError::SUCCESS) {
+            state.SkipWithError(result.errorMessage.c_str());
+            break;
+        }
+        benchmark::DoNotOptimize(refreshRate);
+    }
+    state.SetBytesProcessed(static_cast<int64_t>(state.iterations()) * static_cast<int64_t>(json.size()));
+}
+
+void BM_ParseApiResponse_Typical(benchmark::State& state) {
+    parseJson(state, BenchInputs::typicalJson());
+}
+void BM_ParseApiResponse_MaxSize(benchmark::State& state) {
+    parseJson(state, BenchInputs::maxSizeJson(ApiClient::RESPONSE_BUFFER_SIZE, MAX_URL_LENGTH));
+}
+
+}  // namespace
+
+BENCHMARK(BM_RenderBmp_AllWhite);
+BENCHMARK(BM_RenderBmp_Dense);
+BENCHMARK(BM_RenderBmp_InvertedPalette);
+BENCHMARK(BM_RenderFramebuffer);
+BENCHMARK(BM_DrawChar);
+BENCHMARK(BM_DrawChar_Clipped);
+BENCHMARK(BM_DrawCenteredString);
+BENCHMARK(BM_ParseApiResponse_Typical);
+BENCHMARK(BM_ParseApiResponse_MaxSize);
+
+BENCHMARK_MAIN();
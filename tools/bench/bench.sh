@@ -0,0 +1,92 @@
+#!/usr/bin/env bash
+# Host benchmarks and fuzz targets for the BMP decoder, text drawing and the
+# /api/display parser.
+#
+#   tools/bench/bench.sh run [benchmark args]   build + run, save .bench/results/<sha>.json
+#   tools/bench/bench.sh fuzz bmp|json [args]   build with libFuzzer (clang++) and fuzz
+#   tools/bench/bench.sh replay bmp|json FILES  replay inputs through a target (any compiler)
+#
+# ArduinoJson comes from $ARDUINOJSON_SRC or the PlatformIO libdeps
+# (run `pio pkg install` once). Google Benchmark must be installed for `run`.
+set -euo pipefail
+
+ROOT="$(cd "$(dirname "$0")/../.." && pwd)"
+OUT="$ROOT/.bench"
+CXX="${CXX:-c++}"
+
+AJ="${ARDUINOJSON_SRC:-}"
+if [ -z "$AJ" ]; then
+    AJ="$(ls -d "$ROOT"/.pio/libdeps/*/ArduinoJson/src 2>/dev/null | head -n 1 || true)"
+fi
+if [ -z "$AJ" ] || [ ! -f "$AJ/ArduinoJson.h" ]; then
+    echo "ArduinoJson not found: set ARDUINOJSON_SRC or run 'pio pkg install'" >&2
+    exit 1
+fi
+
+CXXFLAGS=(-std=gnu++17 -O2 -g -Wall -I "$ROOT/tools/host/include" -I "$ROOT/src" -I "$AJ" -I "$ROOT/tools/bench")
+SOURCES=(
+    "$ROOT/src/ImageRenderer.cpp"
+    "$ROOT/src/TextDraw.cpp"
+    "$ROOT/src/ApiResponseParser.cpp"
+    "$ROOT/src/ArenaAllocator.cpp"
+    "$ROOT/tools/host/host_stubs.cpp"
+)
+
+# Image seeds are generated (mock_server's checkerboard as BMP and raw
+# framebuffer) rather than checked in.
+seed_bmp() {
+    mkdir -p "$1"
+    if [ -z "$(ls -A "$1")" ]; then
+        python3 -c "import sys; sys.path.insert(0, '$ROOT/tools'); import mock_server; \
+open('$1/checkerboard.bmp', 'wb').write(mock_server.checkerboard_bmp()); \
+open('$1/checkerboard.fb', 'wb').write(mock_server.checkerboard_framebuffer())"
+    fi
+}
+
+mode="${1:-run}"
+shift || true
+mkdir -p "$OUT"
+
+case "$mode" in
+run)
+    "$CXX" "${CXXFLAGS[@]}" -DNDEBUG "${SOURCES[@]}" "$ROOT/tools/bench/bench.cpp" \
+        -lbenchmark -lpthread -o "$OUT/bench"
+    sha="$(git -C "$ROOT" rev-parse --short HEAD 2>/dev/null || echo local)"
+    if ! git -C "$ROOT" diff --quiet HEAD -- src 2>/dev/null; then
+        sha="$sha-dirty"
+    fi
+    mkdir -p "$OUT/results"
+    "$OUT/bench" --benchmark_out="$OUT/results/$sha.json" --benchmark_out_format=json "$@"
+    echo "results: $OUT/results/$sha.json"
+    ;;
+fuzz)
+    target="${1:?usage: bench.sh fuzz bmp|json [libFuzzer args]}"
+    shift
+    CXX="${CXX_FUZZ:-clang++}"
+    "$CXX" "${CXXFLAGS[@]}" -fsanitize=fuzzer,address,undefined "${SOURCES[@]}" \
+        "$ROOT/tools/bench/fuzz_$target.cpp" -o "$OUT/fuzz_$target"
+    corpus="$OUT/corpus/$target"
+    mkdir -p "$corpus"
+    [ "$target" = bmp ] && seed_bmp "$corpus"
+    seeds=()
+    [ -d "$ROOT/tools/bench/corpus/$target" ] && seeds=("$ROOT/tools/bench/corpus/$target")
+    "$OUT/fuzz_$target" "$corpus" "${seeds[@]}" "$@"
+    ;;
+replay)
+    target="${1:?usage: bench.sh replay bmp|json FILES...}"
+    shift
+    "$CXX" "${CXXFLAGS[@]}" -fsanitize=address,undefined "${SOURCES[@]}" \
+        "$ROOT/tools/bench/fuzz_$target.cpp" "$ROOT/tools/bench/fuzz_replay.cpp" -o "$OUT/replay_$target"
+    if [ $# -eq 0 ] && [ "$target" = bmp ]; then
+        seed_bmp "$OUT/corpus/bmp"
+        set -- "$OUT"/corpus/bmp/*
+    elif [ $# -eq 0 ]; then
+        set -- "$ROOT"/tools/bench/corpus/"$target"/*
+    fi
+    "$OUT/replay_$target" "$@"
+    ;;
+*)
+    echo "usage: bench.sh run|fuzz|replay ..." >&2
+    exit 2
+    ;;
+esac
@@ -0,0 +1,58 @@
+#!/usr/bin/env python3
+"""Compare two Google Benchmark JSON results from tools/bench/bench.sh.
+
+Prints the change in CPU time per benchmark and exits with status 1 if any
+benchmark got slower than --threshold percent, so a pre-commit hook or CI
+step can fail on regressions:
+
+  tools/bench/compare.py .bench/results/<base>.json .bench/results/<new>.json
+"""
+
+import argparse
+import json
+import sys
+
+
+def load(path):
+    with open(path) as f:
+        doc = json.load(f)
+    results = {}
+    for bench in doc.get("benchmarks", []):
+        if bench.get("run_type", "iteration") != "iteration" or "error_occurred" in bench:
+            continue
+        results[bench["name"]] = bench["cpu_time"], bench.get("time_unit", "ns")
+    return results
+
+
+def main():
+    parser = argparse.ArgumentParser(description=__doc__, formatter_class=argparse.RawDescriptionHelpFormatter)
+    parser.add_argument("baseline")
+    parser.add_argument("candidate")
+    parser.add_argument("--threshold", type=float, default=10.0, help="allowed slowdown in percent (default 10)")
+    args = parser.parse_args()
+
+    base = load(args.baseline)
+    new = load(args.candidate)
+
+    regressions = 0
+    print("%-40s %14s %14s %8s" % ("benchmark", "baseline", "candidate", "change"))
+    for name in sorted(set(base) | set(new)):
+        if name not in base or name not in new:
+            print("%-40s %s" % (name, "only in baseline" if name in base else "new"))
+            continue
+        (old_t, unit), (new_t, _) = base[name], new[name]
+        change = (new_t - old_t) / old_t * 100 if old_t else 0.0
+        flag = ""
+        if change > args.threshold:
+            flag = "  REGRESSION"
+            regressions += 1
+        print("%-40s %11.1f %-2s %11.1f %-2s %+7.1f%%%s" % (name, old_t, unit, new_t, unit, change, flag))
+
+    if regressions:
+        print("%d benchmark(s) slower than %.0f%%" % (regressions, args.threshold), file=sys.stderr)
+        return 1
+    return 0
+
+
+if __name__ == "__main__":
+    sys.exit(main())
@@ -0,0 +1,23 @@
+// libFuzzer target: image header validation and decode in ImageRenderer
+// (BMP and raw framebuffer).
+
+#include <stddef.h>
+#include <stdint.h>
+#include <stdlib.h>
+#include <string.h>
+
+#include "ImageRenderer.h"
+
+extern "C" int LLVMFuzzerTestOneInput(const uint8_t* data, size_t size) {
+    static EInkDisplay display;
+    static uint8_t before[EInkDisplay::BUFFER_SIZE];
+    memcpy(before, display.getFrameBuffer(), sizeof(before));
+
+    // A rejected image must leave the previous frame untouched.
+    const ImageRenderer::BmpResult result = ImageRenderer::decode(data, size, display);
+    if (result != ImageRenderer::BmpResult::SUCCESS &&
+        memcmp(before, display.getFrameBuffer(), sizeof(before)) != 0) {
+        abort();
+    }
+    return 0;
+}
@@ -0,0 +1,30 @@
+// libFuzzer target: /api/display response parsing in ApiResponseParser::parse.
+
+#include <stddef.h>
+#include <stdint.h>
+#include <stdlib.h>
+#include <string.h>
+
+#include "ApiResponseParser.h"
+
+extern "C" int LLVMFuzzerTestOneInput(const uint8_t* data, size_t size) {
+    char imageUrl[MAX_URL_LENGTH];
+    memset(imageUrl, 0x5A, sizeof(imageUrl));
+    imageUrl[0] = '\0';
+
+    uint32_t refreshRate = 0;
+    TrmnlStatus status = TrmnlStatus::SUCCESS;
+    FirmwareUpdate firmware;
+    const ApiResult result =
+        ApiResponseParser::parse(reinterpret_cast<const char*>(data), size, imageUrl, refreshRate, status, firmware);
+
+    // Outputs must stay NUL-terminated inside their buffers, whatever the input.
+    if (memchr(imageUrl, '\0', sizeof(imageUrl)) == nullptr || memchr(firmware.url, '\0', sizeof(firmware.url)) == nullptr ||
+        memchr(firmware.sha256, '\0', sizeof(firmware.sha256)) == nullptr) {
+        abort();
+    }
+    if (result.error == ApiError::SUCCESS && status == TrmnlStatus::SUCCESS && (imageUrl[0] == '\0' || refreshRate == 0)) {
+        abort();
+    }
+    return 0;
+}
@@ -0,0 +1,25 @@
+// Runs a fuzz target once per file argument. Used when the compiler has no
+// libFuzzer (e.g. GCC) to replay the seed corpus or a saved crash input.
+
+#include <stdint.h>
+#include <stdio.h>
+
+#include <fstream>
+#include <iterator>
+#include <vector>
+
+extern "C" int LLVMFuzzerTestOneInput(const uint8_t* data, size_t size);
+
+int main(int argc, char** argv) {
+    for (int i = 1; i < argc; ++i) {
+        std::ifstream in(argv[i], std::ios::binary);
+        if (!in) {
+            fprintf(stderr, "cannot read %s\n", argv[i]);
+            return 1;
+        }
+        const std::vector<uint8_t> data((std::istreambuf_iterator<char>(in)), std::istreambuf_iterator<char>());
+        LLVMFuzzerTestOneInput(data.data(), data.size());
+    }
+    printf("replayed %d inputs\n", argc - 1);
+    return 0;
+}
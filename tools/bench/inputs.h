@@ -0,0 +1,101 @@
+#pragma once
+
+// Representative inputs shared by the benchmarks and fuzz seeds.
+
+#include <esp_rom_crc.h>
+#include <stdint.h>
+#include <string.h>
+
+#include <string>
+#include <vector>
+
+namespace BenchInputs {
+
+enum class BmpPattern { ALL_WHITE, DENSE, INVERTED_PALETTE };
+
+// 800x480 1-bit bottom-up BMP with a BITMAPINFOHEADER and a 2-entry palette.
+inline std::vector<uint8_t> makeBmp(const BmpPattern pattern) {
+    const uint32_t width = 800;
+    const uint32_t height = 480;
+    const uint32_t rowSize = ((width + 31) / 32) * 4;
+    const uint32_t offset = 14 + 40 + 8;
+    const uint32_t fileSize = offset + rowSize * height;
+
+    std::vector<uint8_t> bmp(fileSize, 0);
+    auto put16 = [&](size_t at, uint16_t v) {
+        bmp[at] = v & 0xFF;
+        bmp[at + 1] = v >> 8;
+    };
+    auto put32 = [&](size_t at, uint32_t v) {
+        for (int i = 0; i < 4; ++i) {
+            bmp[at + i] = (v >> (8 * i)) & 0xFF;
+        }
+    };
+
+    put16(0, 0x4D42);
+    put32(2, fileSize);
+    put32(10, offset);
+    put32(14, 40);
+    put32(18, width);
+    put32(22, height);
+    put16(26, 1);
+    put16(28, 1);
+    put32(34, rowSize * height);
+
+    // Palette: index 0 black, index 1 white; swapped for INVERTED_PALETTE so
+    // the renderer takes its inversion path.
+    const bool inverted = pattern == BmpPattern::INVERTED_PALETTE;
+    put32(54, inverted ? 0x00FFFFFF : 0x00000000);
+    put32(58, inverted ? 0x00000000 : 0x00FFFFFF);
+
+    uint32_t lfsr = 0xACE1u;
+    for (uint32_t i = offset; i < fileSize; ++i) {
+        if (pattern == BmpPattern::ALL_WHITE) {
+            bmp[i] = 0xFF;
+        } else {
+            lfsr = lfsr * 1103515245u + 12345u;
+            bmp[i] = static_cast<uint8_t>(lfsr >> 16);
+        }
+    }
+    return bmp;
+}
+
+// Raw framebuffer (ImageRenderer::FRAMEBUFFER_MAGIC) with pseudo-random pixels.
+inline std::vector<uint8_t> makeFramebuffer() {
+    const uint32_t pixelBytes = (800 / 8) * 480;
+    std::vector<uint8_t> fb(16 + pixelBytes, 0);
+    const uint8_t header[12] = {'T', 'R', 'F', 'B', 1, 0, 0x20, 0x03, 0xE0, 0x01, 0, 0};
+    memcpy(fb.data(), header, sizeof(header));
+
+    uint32_t lfsr = 0xACE1u;
+    for (uint32_t i = 16; i < fb.size(); ++i) {
+        lfsr = lfsr * 1103515245u + 12345u;
+        fb[i] = static_cast<uint8_t>(lfsr >> 16);
+    }
+    const uint32_t crc = esp_rom_crc32_le(0, fb.data() + 16, pixelBytes);
+    for (int i = 0; i < 4; ++i) {
+        fb[12 + i] = (crc >> (8 * i)) & 0xFF;
+    }
+    return fb;
+}
+
+inline std::string typicalJson() {
+    return R"({"status":0,"image_url":"https://usetrmnl.com/plugin-renders/abc123.bmp","filename":"abc123",)"
+           R"("refresh_rate":"1800","update_firmware":false})";
+}
+
+// Fills the response buffer: maximum-length URLs, firmware fields and an
+// ignored padding field up to maxBytes - 1.
+inline std::string maxSizeJson(const size_t maxBytes, const size_t maxUrl) {
+    const std::string url = "https://example.com/" + std::string(maxUrl - 1 - 20, 'a');
+    std::string json = R"({"status":0,"image_url":")" + url + R"(","refresh_rate":900,"update_firmware":true,)" +
+                       R"("firmware_url":")" + url + R"(","firmware_sha256":")" + std::string(64, 'f') +
+                       R"(","padding":")";
+    const std::string tail = "\"}";
+    if (json.size() + tail.size() < maxBytes - 1) {
+        json.append(maxBytes - 1 - json.size() - tail.size(), 'x');
+    }
+    return json + tail;
+}
+
+}  // namespace BenchInputs
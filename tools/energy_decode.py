@@ -0,0 +1,157 @@
+#!/usr/bin/env python3
+"""Decode the RTC energy ring buffer dumped by EnergyMeter::dump().
+
+The firmware prints one line per boot while serial is attached:
+
+    ENERGY 47524e4501...
+
+Pass a captured serial log (the last ENERGY line wins) or a raw binary dump.
+Use --compare with a second capture to diff two firmware builds.
+"""
+
+import argparse
+import json
+import re
+import struct
+import sys
+
+RECORD_MAGIC = 0x454E5247
+RECORD_VERSION = 2
+RING_SIZE = 16
+
+HEADER = struct.Struct("<IBBBBI")
+RECORD = struct.Struct("<I5IIIHBB")
+STATES = ("cpu", "transfer", "display", "idle", "light_sleep")
+
+# Must match EnergyModel defaults in src/ConfigLoader.h
+DEFAULT_MODEL = {
+    "cpu_ma": 25,
+    "radio_transfer_ma": 110,
+    "radio_listen_ma": 70,
+    "display_ma": 28,
+    "idle_ma": 20,
+    "light_sleep_ua": 2000,
+    "sleep_ua": 60,
+}
+
+WAKE_CAUSES = {0: "reset", 4: "timer", 7: "gpio"}
+
+
+def load_blob(path):
+    with open(path, "rb") as f:
+        data = f.read()
+    text = data.decode("ascii", errors="ignore")
+    matches = re.findall(r"ENERGY ([0-9a-fA-F]+)", text)
+    if matches:
+        return bytes.fromhex(matches[-1])
+    return data
+
+
+def decode(blob):
+    if len(blob) < HEADER.size + RING_SIZE * RECORD.size:
+        raise ValueError("dump too short: %d bytes" % len(blob))
+    magic, version, head, count, _reserved, next_seq = HEADER.unpack_from(blob, 0)
+    if magic != RECORD_MAGIC:
+        raise ValueError("bad magic 0x%08x" % magic)
+    if version != RECORD_VERSION:
+        raise ValueError("unsupported record version %d" % version)
+
+    records = []
+    for i in range(RING_SIZE):
+        fields = RECORD.unpack_from(blob, HEADER.size + i * RECORD.size)
+        records.append({
+            "seq": fields[0],
+            "cpu": fields[1],
+            "transfer": fields[2],
+            "display": fields[3],
+            "idle": fields[4],
+            "light_sleep": fields[5],
+            "radio": fields[6],
+            "sleep_s": fields[7],
+            "battery_mv": fields[8],
+            "wake_cause": fields[9],
+        })
+
+    # Oldest first: when the ring is full the oldest record sits at head.
+    if count < RING_SIZE:
+        ordered = records[:count]
+    else:
+        ordered = records[head:] + records[:head]
+    return next_seq, ordered
+
+
+def estimate_uah(rec, model):
+    uas = (rec["cpu"] * model["cpu_ma"] + rec["transfer"] * model["radio_transfer_ma"] +
+           rec["display"] * model["display_ma"] + rec["idle"] * model["idle_ma"])
+    uas += rec["light_sleep"] * model["light_sleep_ua"] // 1000
+    uas += max(rec["radio"] - rec["transfer"], 0) * model["radio_listen_ma"]
+    uas += rec["sleep_s"] * model["sleep_ua"]
+    return uas // 3600
+
+
+def summarize(records, model):
+    n = len(records)
+    if n == 0:
+        return {"n": 0}
+    out = {"n": n}
+    for key in STATES + ("radio", "sleep_s"):
+        out[key] = sum(r[key] for r in records) / n
+    out["awake_ms"] = sum(out[s] for s in STATES)
+    out["uah"] = sum(estimate_uah(r, model) for r in records) / n
+    return out
+
+
+def print_records(records, model):
+    print("seq,cause,cpu_ms,transfer_ms,display_ms,idle_ms,light_sleep_ms,radio_ms,sleep_s,battery_mv,uah")
+    for r in records:
+        print("%d,%s,%d,%d,%d,%d,%d,%d,%d,%d,%d" % (
+            r["seq"], WAKE_CAUSES.get(r["wake_cause"], str(r["wake_cause"])), r["cpu"], r["transfer"],
+            r["display"], r["idle"], r["light_sleep"], r["radio"], r["sleep_s"], r["battery_mv"], estimate_uah(r, model)))
+
+
+def print_summary(label, s):
+    if s["n"] == 0:
+        print("%s: no records" % label)
+        return
+    print("%s: n=%d awake=%.0fms (cpu %.0f, transfer %.0f, display %.0f, idle %.0f, light sleep %.0f) "
+          "radio=%.0fms sleep=%.0fs -> %.1f uAh/wake" % (label, s["n"], s["awake_ms"], s["cpu"], s["transfer"],
+                                                         s["display"], s["idle"], s["light_sleep"], s["radio"],
+                                                         s["sleep_s"], s["uah"]))
+
+
+def main():
+    parser = argparse.ArgumentParser(description=__doc__, formatter_class=argparse.RawDescriptionHelpFormatter)
+    parser.add_argument("dump", help="serial log containing an ENERGY line, or a raw binary dump")
+    parser.add_argument("--compare", metavar="DUMP", help="second dump to compare against (baseline)")
+    parser.add_argument("--model", metavar="JSON",
+                        help="JSON file with an energy_model object (same keys as trmnl-config.json)")
+    args = parser.parse_args()
+
+    model = dict(DEFAULT_MODEL)
+    if args.model:
+        with open(args.model) as f:
+            cfg = json.load(f)
+        model.update(cfg.get("energy_model", cfg))
+
+    try:
+        _, records = decode(load_blob(args.dump))
+        print_records(records, model)
+        current = summarize(records, model)
+        print()
+        print_summary("current", current)
+
+        if args.compare:
+            _, base_records = decode(load_blob(args.compare))
+            baseline = summarize(base_records, model)
+            print_summary("baseline", baseline)
+            if current["n"] and baseline["n"] and baseline["uah"]:
+                delta = current["uah"] - baseline["uah"]
+                print("delta: %+.1f uAh/wake (%+.1f%%)" % (delta, 100.0 * delta / baseline["uah"]))
+    except ValueError as e:
+        print("ERROR: %s" % e, file=sys.stderr)
+        return 1
+    return 0
+
+
+if __name__ == "__main__":
+    sys.exit(main())
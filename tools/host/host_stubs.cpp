@@ -0,0 +1,21 @@
+// Host replacements for firmware modules that need RTC memory, the SD card
+// or the radio. Linked into host tools instead of the real .cpp files.
+
+#include <Arduino.h>
+
+#include <chrono>
+
+#include "EnergyMeter.h"
+#include "Telemetry.h"
+
+uint32_t millis() {
+    static const auto start = std::chrono::steady_clock::now();
+    return static_cast<uint32_t>(
+        std::chrono::duration_cast<std::chrono::milliseconds>(std::chrono::steady_clock::now() - start).count());
+}
+
+EnergyMeter::State EnergyMeter::enter(const State state) {
+    return state;
+}
+
+void Telemetry::record(Event, int32_t, int32_t, int32_t) {}
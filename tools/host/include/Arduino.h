@@ -0,0 +1,53 @@
+#pragma once
+
+// Just enough of the Arduino core to build display/parsing modules from src/
+// on a desktop host (tools/bench and other host tools). Not a general shim:
+// add to it when a new module needs more.
+
+#include <stddef.h>
+#include <stdint.h>
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+
+#include <string>
+
+#define RTC_DATA_ATTR
+
+class String {
+public:
+    String() {}
+    String(const char* s) : s_(s ? s : "") {}
+    String(const std::string& s) : s_(s) {}
+
+    const char* c_str() const { return s_.c_str(); }
+    unsigned int length() const { return static_cast<unsigned int>(s_.size()); }
+    bool isEmpty() const { return s_.empty(); }
+    bool startsWith(const char* prefix) const { return s_.rfind(prefix, 0) == 0; }
+    bool endsWith(const char* suffix) const {
+        const size_t n = strlen(suffix);
+        return s_.size() >= n && s_.compare(s_.size() - n, n, suffix) == 0;
+    }
+    bool operator==(const String& other) const { return s_ == other.s_; }
+    bool operator!=(const String& other) const { return s_ != other.s_; }
+
+private:
+    std::string s_;
+};
+
+// Declared by module interfaces (dump(Print&)); host tools never print through it.
+class Print;
+
+uint32_t millis();
+
+// glibc only gained strlcpy in 2.38.
+inline size_t hostStrlcpy(char* dst, const char* src, size_t size) {
+    const size_t len = strlen(src);
+    if (size > 0) {
+        const size_t n = len < size - 1 ? len : size - 1;
+        memcpy(dst, src, n);
+        dst[n] = '\0';
+    }
+    return len;
+}
+#define strlcpy hostStrlcpy
@@ -0,0 +1,31 @@
+#pragma once
+
+// Host stand-in for the open-x4-sdk EInkDisplay: same geometry and
+// framebuffer layout (1 bit per pixel, MSB first, 1 = white), no panel.
+
+#include <stdint.h>
+#include <string.h>
+
+class EInkDisplay {
+public:
+    enum RefreshMode { FULL_REFRESH, HALF_REFRESH, FAST_REFRESH };
+
+    static constexpr uint16_t DISPLAY_WIDTH = 800;
+    static constexpr uint16_t DISPLAY_HEIGHT = 480;
+    static constexpr uint16_t DISPLAY_WIDTH_BYTES = DISPLAY_WIDTH / 8;
+    static constexpr uint32_t BUFFER_SIZE = DISPLAY_WIDTH_BYTES * DISPLAY_HEIGHT;
+
+    EInkDisplay(int8_t = -1, int8_t = -1, int8_t = -1, int8_t = -1, int8_t = -1, int8_t = -1) { clearScreen(); }
+
+    void begin() {}
+    void clearScreen(uint8_t color = 0xFF) { memset(frameBuffer_, color, sizeof(frameBuffer_)); }
+    void displayBuffer(RefreshMode = FAST_REFRESH, bool = false) { refreshCount++; }
+    void displayWindow(uint16_t, uint16_t, uint16_t, uint16_t, bool = false) { refreshCount++; }
+    uint8_t* getFrameBuffer() { return frameBuffer_; }
+    void deepSleep() {}
+
+    uint32_t refreshCount = 0;  ///< Host only: number of refreshes requested
+
+private:
+    uint8_t frameBuffer_[BUFFER_SIZE];
+};
@@ -0,0 +1,27 @@
+#pragma once
+
+// Host version of the ESP32 ROM CRC-32 (same result as zlib crc32()).
+// Table-driven like the ROM, so benchmarks see a comparable cost.
+
+#include <stdint.h>
+
+inline uint32_t esp_rom_crc32_le(uint32_t crc, const uint8_t* buf, uint32_t len) {
+    static const struct Table {
+        uint32_t entries[256];
+        Table() {
+            for (uint32_t i = 0; i < 256; ++i) {
+                uint32_t c = i;
+                for (int k = 0; k < 8; ++k) {
+                    c = (c >> 1) ^ (0xEDB88320u & (0u - (c & 1u)));
+                }
+                entries[i] = c;
+            }
+        }
+    } table;
+
+    crc = ~crc;
+    while (len--) {
+        crc = table.entries[(crc ^ *buf++) & 0xFF] ^ (crc >> 8);
+    }
+    return ~crc;
+}
@@ -0,0 +1,944 @@
+// Fleet load generator: N simulated devices waking on their own schedules
+// against a TRMNL/BYOS server. Requests are built with the firmware's
+// ApiRequest, responses parsed with ApiResponseParser, and the next wake is
+// planned with RefreshPlanner and WakeBudget, so the server sees what a fleet
+// of this firmware would send. Build and run with tools/loadgen/loadgen.sh.
+//
+//   loadgen --server URL [--devices N] [--duration S] [--speed X] [--workers W]
+//           [--interval S] [--align S] [--drift-ppm P] [--jitter-ms MS] [--herd]
+//           [--api-key KEY | --keys FILE] [--csv FILE] [--report S] [--seed N]
+//
+// Exit status is 1 if any wake failed.
+
+#include <netdb.h>
+#include <strings.h>
+#include <openssl/err.h>
+#include <openssl/ssl.h>
+#include <sys/socket.h>
+#include <sys/time.h>
+#include <unistd.h>
+
+#include <algorithm>
+#include <atomic>
+#include <cerrno>
+#include <chrono>
+#include <condition_variable>
+#include <cstring>
+#include <deque>
+#include <map>
+#include <mutex>
+#include <queue>
+#include <random>
+#include <string>
+#include <thread>
+#include <vector>
+
+#include "ApiClient.h"
+#include "ApiRequest.h"
+#include "ApiResponseParser.h"
+#include "LogUploader.h"
+#include "RefreshPlanner.h"
+#include "WakeBudget.h"
+
+namespace {
+
+using Clock = std::chrono::steady_clock;
+
+struct Options {
+    std::string server;
+    std::string apiKey = "loadgen";
+    std::string keysPath;
+    std::string csvPath;
+    int devices = 100;
+    int workers = 32;
+    double duration = 60.0;   ///< Real seconds
+    double speed = 1.0;       ///< Simulated seconds per real second
+    uint32_t interval = 1800; ///< refresh_interval: first Refresh-Rate header and backoff cap
+    uint32_t align = 0;       ///< wake_align
+    int driftPpm = 2000;      ///< Per-device sleep timer error, uniform in +-driftPpm
+    int jitterMs = 4000;      ///< Boot + WiFi time before the request, uniform in [0, jitterMs]
+    bool herd = false;        ///< Every device's first wake at t = 0
+    double report = 10.0;
+    unsigned seed = 1;
+};
+
+// ---------------------------------------------------------------------------
+// Minimal HTTP/1.1 client over TCP or TLS. The image gets a connection of its
+// own, like the firmware's download; /api/log reuses the /api/display one when
+// the server kept it alive. TLS sessions are never resumed, as a device coming
+// out of deep sleep has none to resume.
+
+struct Url {
+    bool tls = false;
+    std::string host;
+    std::string port;
+    std::string path;
+};
+
+bool parseUrl(const std::string& text, Url& out) {
+    size_t rest;
+    if (text.compare(0, 8, "https://") == 0) {
+        out.tls = true;
+        rest = 8;
+    } else if (text.compare(0, 7, "http://") == 0) {
+        out.tls = false;
+        rest = 7;
+    } else {
+        return false;
+    }
+    const size_t slash = text.find('/', rest);
+    const std::string authority = text.substr(rest, slash == std::string::npos ? std::string::npos : slash - rest);
+    out.path = slash == std::string::npos ? "/" : text.substr(slash);
+    const size_t colon = authority.rfind(':');
+    if (colon != std::string::npos && authority.find(']') == std::string::npos) {
+        out.host = authority.substr(0, colon);
+        out.port = authority.substr(colon + 1);
+    } else {
+        out.host = authority;
+        out.port = out.tls ? "443" : "80";
+    }
+    return !out.host.empty();
+}
+
+enum class Outcome { OK, CONNECT, TLS, TIMEOUT, PROTOCOL, TOO_LARGE };
+
+const char* outcomeName(const Outcome outcome) {
+    switch (outcome) {
+        case Outcome::OK: return "ok";
+        case Outcome::CONNECT: return "connect";
+        case Outcome::TLS: return "tls";
+        case Outcome::TIMEOUT: return "timeout";
+        case Outcome::PROTOCOL: return "protocol";
+        case Outcome::TOO_LARGE: return "too_large";
+    }
+    return "?";
+}
+
+void setTimeouts(const int fd, const uint32_t ms) {
+    timeval tv;
+    tv.tv_sec = static_cast<time_t>(ms / 1000u);
+    tv.tv_usec = static_cast<suseconds_t>((ms % 1000u) * 1000u);
+    setsockopt(fd, SOL_SOCKET, SO_RCVTIMEO, &tv, sizeof(tv));
+    setsockopt(fd, SOL_SOCKET, SO_SNDTIMEO, &tv, sizeof(tv));
+}
+
+class Connection {
+public:
+    ~Connection() { close(); }
+
+    Outcome open(const Url& url, SSL_CTX* ctx, const uint32_t timeoutMs) {
+        addrinfo hints = {};
+        hints.ai_family = AF_UNSPEC;
+        hints.ai_socktype = SOCK_STREAM;
+        addrinfo* found = nullptr;
+        if (getaddrinfo(url.host.c_str(), url.port.c_str(), &hints, &found) != 0) {
+            return Outcome::CONNECT;
+        }
+        for (addrinfo* ai = found; ai != nullptr && fd_ < 0; ai = ai->ai_next) {
+            fd_ = socket(ai->ai_family, ai->ai_socktype, ai->ai_protocol);
+            if (fd_ < 0) {
+                continue;
+            }
+            // Linux applies SO_SNDTIMEO to connect().
+            setTimeouts(fd_, static_cast<uint32_t>(ApiClient::SERVER_CONNECT_TIMEOUT_MS));
+            if (connect(fd_, ai->ai_addr, ai->ai_addrlen) != 0) {
+                ::close(fd_);
+                fd_ = -1;
+            }
+        }
+        freeaddrinfo(found);
+        if (fd_ < 0) {
+            return Outcome::CONNECT;
+        }
+        setTimeouts(fd_, timeoutMs);
+        dead_ = false;
+
+        if (url.tls) {
+            ssl_ = SSL_new(ctx);
+            SSL_set_fd(ssl_, fd_);
+            SSL_set_tlsext_host_name(ssl_, url.host.c_str());
+            if (SSL_connect(ssl_) != 1) {
+                return Outcome::TLS;
+            }
+        }
+        return Outcome::OK;
+    }
+
+    bool send(const std::string& data) {
+        size_t sent = 0;
+        while (sent < data.size()) {
+            const int n = ssl_ != nullptr ? SSL_write(ssl_, data.data() + sent, static_cast<int>(data.size() - sent))
+                                           : static_cast<int>(::send(fd_, data.data() + sent, data.size() - sent,
+                                                                     MSG_NOSIGNAL));
+            if (n <= 0) {
+                return false;
+            }
+            sent += static_cast<size_t>(n);
+        }
+        return true;
+    }
+
+    /// Bytes read; 0 once the peer closed; -1 on timeout; -2 on any other error.
+    int recv(char* dst, const size_t size) {
+        if (ssl_ != nullptr) {
+            const int n = SSL_read(ssl_, dst, static_cast<int>(size));
+            if (n > 0) {
+                return n;
+            }
+            const int error = SSL_get_error(ssl_, n);
+            if (error == SSL_ERROR_ZERO_RETURN) {
+                return 0;
+            }
+            if (error == SSL_ERROR_SYSCALL && (errno == EAGAIN || errno == EWOULDBLOCK)) {
+                return -1;
+            }
+            // Many servers close without close_notify; with a known length that is never reached.
+            return error == SSL_ERROR_SYSCALL || error == SSL_ERROR_SSL ? 0 : -2;
+        }
+        const ssize_t n = ::recv(fd_, dst, size, 0);
+        if (n >= 0) {
+            return static_cast<int>(n);
+        }
+        return (errno == EAGAIN || errno == EWOULDBLOCK) ? -1 : -2;
+    }
+
+    bool isOpen() const { return fd_ >= 0 && !dead_; }
+
+    /// The server said Connection: close, or the body ran to the end of the stream.
+    void markDead() { dead_ = true; }
+
+    void close() {
+        if (ssl_ != nullptr) {
+            SSL_free(ssl_);
+            ssl_ = nullptr;
+        }
+        if (fd_ >= 0) {
+            ::close(fd_);
+            fd_ = -1;
+        }
+    }
+
+private:
+    int fd_ = -1;
+    SSL* ssl_ = nullptr;
+    bool dead_ = false;
+};
+
+struct HttpResponse {
+    int status = 0;
+    std::map<std::string, std::string> headers;  ///< Lower-case names
+    std::string body;
+    uint32_t connectMs = 0;  ///< TCP connect and TLS handshake
+    uint32_t ttfbMs = 0;     ///< Request sent to first response byte
+    uint32_t totalMs = 0;
+};
+
+using HeaderList = std::vector<std::pair<std::string, std::string>>;
+
+// One LogUploader queue entry. Messages are loadgen error names, which need no escaping.
+struct QueuedLog {
+    uint32_t id;
+    uint32_t epoch;
+    int32_t code;
+    std::string message;
+};
+
+uint32_t msSince(const Clock::time_point start) {
+    return static_cast<uint32_t>(std::chrono::duration_cast<std::chrono::milliseconds>(Clock::now() - start).count());
+}
+
+class Reader {
+public:
+    explicit Reader(Connection& connection) : connection_(connection) {}
+
+    Outcome line(std::string& out) {
+        for (;;) {
+            const size_t end = buffer_.find("\r\n", pos_);
+            if (end != std::string::npos) {
+                out = buffer_.substr(pos_, end - pos_);
+                pos_ = end + 2;
+                return Outcome::OK;
+            }
+            const Outcome outcome = fill();
+            if (outcome != Outcome::OK) {
+                return outcome;
+            }
+        }
+    }
+
+    Outcome exact(const size_t size, std::string& out) {
+        while (buffer_.size() - pos_ < size) {
+            const Outcome outcome = fill();
+            if (outcome != Outcome::OK) {
+                return outcome;
+            }
+        }
+        out.append(buffer_, pos_, size);
+        pos_ += size;
+        return Outcome::OK;
+    }
+
+    Outcome toClose(std::string& out, const size_t limit) {
+        for (;;) {
+            out.append(buffer_, pos_, std::string::npos);
+            pos_ = buffer_.size();
+            if (out.size() > limit) {
+                return Outcome::TOO_LARGE;
+            }
+            const Outcome outcome = fill();
+            if (outcome == Outcome::PROTOCOL) {
+                return Outcome::OK;  // Closed: the body ends here.
+            }
+            if (outcome != Outcome::OK) {
+                return outcome;
+            }
+        }
+    }
+
+private:
+    // PROTOCOL when the peer closed before more data arrived.
+    Outcome fill() {
+        if (pos_ > 0 && pos_ == buffer_.size()) {
+            buffer_.clear();
+            pos_ = 0;
+        }
+        char chunk[16384];
+        const int n = connection_.recv(chunk, sizeof(chunk));
+        if (n > 0) {
+            buffer_.append(chunk, static_cast<size_t>(n));
+            return Outcome::OK;
+        }
+        return n == 0 ? Outcome::PROTOCOL : (n == -1 ? Outcome::TIMEOUT : Outcome::PROTOCOL);
+    }
+
+    Connection& connection_;
+    std::string buffer_;
+    size_t pos_ = 0;
+};
+
+Outcome readBody(Reader& reader, const HttpResponse& response, const size_t maxBody, std::string& body) {
+    const auto encoding = response.headers.find("transfer-encoding");
+    if (encoding != response.headers.end() && encoding->second.find("chunked") != std::string::npos) {
+        for (;;) {
+            std::string sizeLine;
+            Outcome outcome = reader.line(sizeLine);
+            if (outcome != Outcome::OK) {
+                return outcome;
+            }
+            const size_t chunk = strtoul(sizeLine.c_str(), nullptr, 16);
+            if (chunk == 0) {
+                std::string trailer;
+                do {
+                    outcome = reader.line(trailer);
+                } while (outcome == Outcome::OK && !trailer.empty());
+                return outcome;
+            }
+            if (body.size() + chunk > maxBody) {
+                return Outcome::TOO_LARGE;
+            }
+            std::string crlf;
+            if ((outcome = reader.exact(chunk, body)) != Outcome::OK || (outcome = reader.line(crlf)) != Outcome::OK) {
+                return outcome;
+            }
+        }
+    }
+
+    const auto length = response.headers.find("content-length");
+    if (length != response.headers.end()) {
+        const size_t size = strtoul(length->second.c_str(), nullptr, 10);
+        return size > maxBody ? Outcome::TOO_LARGE : reader.exact(size, body);
+    }
+    return reader.toClose(body, maxBody);
+}
+
+// Sends one request on connection, opening it first unless it is still open
+// from the previous request. keepAlive leaves it open afterwards if the server
+// agrees, as HTTPClient does with setReuse(true).
+Outcome httpRequest(Connection& connection, const char* method, const Url& url, const HeaderList& headers,
+                    const std::string& body, const bool keepAlive, SSL_CTX* ctx, const uint32_t timeoutMs,
+                    const size_t maxBody, HttpResponse& response) {
+    const auto start = Clock::now();
+    Outcome outcome = Outcome::OK;
+    if (!connection.isOpen()) {
+        connection.close();
+        outcome = connection.open(url, ctx, timeoutMs);
+        response.connectMs = msSince(start);
+        if (outcome != Outcome::OK) {
+            return outcome;
+        }
+    }
+
+    // What HTTPClient sends, then the caller's headers.
+    std::string request = std::string(method) + " " + url.path + " HTTP/1.1\r\nHost: " + url.host;
+    if (url.port != (url.tls ? "443" : "80")) {
+        request += ":" + url.port;
+    }
+    request += "\r\nUser-Agent: ESP32HTTPClient\r\nConnection: ";
+    request += keepAlive ? "keep-alive" : "close";
+    request += "\r\nAccept-Encoding: identity;q=1,chunked;q=0.1,*;q=0\r\n";
+    for (const auto& header : headers) {
+        request += header.first + ": " + header.second + "\r\n";
+    }
+    if (!body.empty()) {
+        request += "Content-Length: " + std::to_string(body.size()) + "\r\n";
+    }
+    request += "\r\n" + body;
+    const auto sent = Clock::now();
+    if (!connection.send(request)) {
+        return Outcome::PROTOCOL;
+    }
+
+    Reader reader(connection);
+    std::string statusLine;
+    if ((outcome = reader.line(statusLine)) != Outcome::OK) {
+        return outcome;
+    }
+    response.ttfbMs = msSince(sent);
+    if (sscanf(statusLine.c_str(), "HTTP/%*d.%*d %d", &response.status) != 1) {
+        return Outcome::PROTOCOL;
+    }
+    for (;;) {
+        std::string line;
+        if ((outcome = reader.line(line)) != Outcome::OK) {
+            return outcome;
+        }
+        if (line.empty()) {
+            break;
+        }
+        const size_t colon = line.find(':');
+        if (colon == std::string::npos) {
+            return Outcome::PROTOCOL;
+        }
+        std::string name = line.substr(0, colon);
+        std::transform(name.begin(), name.end(), name.begin(), ::tolower);
+        const size_t value = line.find_first_not_of(' ', colon + 1);
+        response.headers[name] = value == std::string::npos ? "" : line.substr(value);
+    }
+
+    outcome = readBody(reader, response, maxBody, response.body);
+    response.totalMs = msSince(start);
+
+    const auto closeHeader = response.headers.find("connection");
+    const bool framed = response.headers.count("content-length") != 0 || response.headers.count("transfer-encoding") != 0;
+    if (!keepAlive || !framed || outcome != Outcome::OK ||
+        (closeHeader != response.headers.end() && strcasecmp(closeHeader->second.c_str(), "close") == 0)) {
+        connection.markDead();
+    }
+    return outcome;
+}
+
+// /api/log body in LogUploader's format: as many queued entries as fit in its byte budget.
+std::string logBody(const std::deque<QueuedLog>& logs, const uint32_t dropped, size_t& packed) {
+    const std::string suffix = "]}}";
+    std::string body = "{\"dropped_entries\":" + std::to_string(dropped) + ",\"log\":{\"logs_array\":[";
+    for (packed = 0; packed < logs.size(); ++packed) {
+        const QueuedLog& log = logs[packed];
+        char entry[LogUploader::MESSAGE_MAX + 128];
+        snprintf(entry, sizeof(entry),
+                 "%s{\"log_id\":%u,\"creation_timestamp\":%u,\"log_codeline\":%d,\"log_message\":\"%s\"}",
+                 packed ? "," : "", log.id, log.epoch, static_cast<int>(log.code), log.message.c_str());
+        if (body.size() + strlen(entry) + suffix.size() >= LogUploader::BYTE_BUDGET) {
+            break;
+        }
+        body += entry;
+    }
+    return body + suffix;
+}
+
+// ---------------------------------------------------------------------------
+// Fleet
+
+struct Device {
+    TrmnlConfig config;
+    double volts = 0.0;
+    int rssi = 0;
+    double timerScale = 1.0;    ///< 1 + drift: how long the sleep timer really runs
+    uint32_t refreshRate = 0;   ///< Refresh-Rate header: the last planned interval
+    uint16_t failedWakes = 0;
+    std::deque<QueuedLog> logs; ///< LogUploader's RTC queue: one entry per failed wake
+    uint32_t nextLogId = 1;
+    uint32_t droppedLogs = 0;
+};
+
+struct Due {
+    Clock::time_point at;
+    size_t device;
+    bool operator>(const Due& other) const { return at > other.at; }
+};
+
+struct Stats {
+    std::mutex mutex;
+    uint32_t wakes = 0;
+    uint32_t noUpdate = 0;
+    uint32_t images = 0;
+    uint64_t imageBytes = 0;
+    std::vector<uint32_t> displayMs;
+    std::vector<uint32_t> ttfbMs;
+    std::vector<uint32_t> connectMs;
+    std::vector<uint32_t> imageMs;
+    std::vector<uint32_t> logMs;
+    std::vector<uint32_t> lagMs;
+    uint32_t logsSent = 0;      ///< Log entries the server accepted
+    uint32_t logFailures = 0;   ///< /api/log POSTs answered with a non-2xx status
+    std::map<std::string, uint32_t> errors;
+    FILE* csv = nullptr;
+};
+
+class Fleet {
+public:
+    Fleet(const Options& options, SSL_CTX* ctx) : options_(options), ctx_(ctx), rng_(options.seed) {}
+
+    void addDevice(const std::string& id, const std::string& apiKey) {
+        Device device;
+        device.config.deviceId = id.c_str();
+        device.config.apiKey = apiKey.c_str();
+        device.config.serverUrls.push_back(options_.server.c_str());
+        device.config.refreshInterval = options_.interval;
+        device.config.wakeAlignSeconds = options_.align;
+        device.volts = std::uniform_real_distribution<double>(3.55, 4.15)(rng_);
+        device.rssi = std::uniform_int_distribution<int>(-85, -45)(rng_);
+        device.timerScale = 1.0 + std::uniform_int_distribution<int>(-options_.driftPpm, options_.driftPpm)(rng_) * 1e-6;
+        device.refreshRate = options_.interval;
+        devices_.push_back(device);
+    }
+
+    size_t size() const { return devices_.size(); }
+
+    void run(Stats& stats) {
+        start_ = Clock::now();
+        std::uniform_real_distribution<double> firstWake(0.0, options_.interval);
+        for (size_t i = 0; i < devices_.size(); ++i) {
+            queue_.push({start_ + realDuration(options_.herd ? 0.0 : firstWake(rng_)), i});
+        }
+
+        std::vector<std::thread> workers;
+        for (int i = 0; i < options_.workers; ++i) {
+            workers.emplace_back([this, &stats, i] { work(stats, options_.seed * 7919u + static_cast<unsigned>(i)); });
+        }
+
+        const auto end = start_ + std::chrono::duration_cast<Clock::duration>(std::chrono::duration<double>(options_.duration));
+        auto nextReport = start_ + std::chrono::duration_cast<Clock::duration>(std::chrono::duration<double>(options_.report));
+        while (Clock::now() < end) {
+            std::this_thread::sleep_until(std::min(end, nextReport));
+            if (Clock::now() >= nextReport) {
+                progress(stats);
+                nextReport += std::chrono::duration_cast<Clock::duration>(std::chrono::duration<double>(options_.report));
+            }
+        }
+        {
+            std::lock_guard<std::mutex> lock(queueMutex_);
+            stopping_ = true;
+        }
+        queueReady_.notify_all();
+        for (std::thread& worker : workers) {
+            worker.join();
+        }
+    }
+
+    double elapsedSeconds() const { return std::chrono::duration<double>(Clock::now() - start_).count(); }
+
+private:
+    Clock::duration realDuration(const double simulatedSeconds) const {
+        return std::chrono::duration_cast<Clock::duration>(std::chrono::duration<double>(simulatedSeconds / options_.speed));
+    }
+
+    // Simulated wall clock for RefreshPlanner (quiet hours, wake_align).
+    time_t simulatedNow() const {
+        return epoch0_ + static_cast<time_t>(elapsedSeconds() * options_.speed);
+    }
+
+    void work(Stats& stats, const unsigned seed) {
+        std::mt19937 rng(seed);
+        for (;;) {
+            Due due;
+            {
+                std::unique_lock<std::mutex> lock(queueMutex_);
+                while (!stopping_ && (queue_.empty() || queue_.top().at > Clock::now())) {
+                    if (queue_.empty()) {
+                        queueReady_.wait(lock);
+                    } else {
+                        queueReady_.wait_until(lock, queue_.top().at);
+                    }
+                }
+                if (stopping_) {
+                    return;
+                }
+                due = queue_.top();
+                queue_.pop();
+            }
+
+            const double sleepSeconds = wake(devices_[due.device], due.at, rng, stats);
+            {
+                std::lock_guard<std::mutex> lock(queueMutex_);
+                queue_.push({Clock::now() + realDuration(sleepSeconds), due.device});
+            }
+            queueReady_.notify_one();
+        }
+    }
+
+    // One wake as the firmware does it. Returns the simulated seconds until the next one.
+    double wake(Device& device, const Clock::time_point dueAt, std::mt19937& rng, Stats& stats) {
+        const uint32_t lagMs = msSince(dueAt);
+        std::string error;
+        HttpResponse display;
+        HttpResponse log;
+        HttpResponse image;
+        uint32_t serverRate = 0;
+        TrmnlStatus status = TrmnlStatus::SUCCESS;
+
+        char energySummary[96];
+        snprintf(energySummary, sizeof(energySummary), "n=8 avg_uah=%u avg_awake_ms=%u avg_radio_ms=%u", 95u,
+                 6000u + std::uniform_int_distribution<unsigned>(0, 4000)(rng), 3500u);
+        ApiRequest::DeviceState state;
+        state.refreshRate = device.refreshRate;
+        state.batteryVolts = device.volts;
+        state.rssi = device.rssi + std::uniform_int_distribution<int>(-3, 3)(rng);
+        state.energySummary = energySummary;
+        const ApiRequest::DisplayHeaders headers(device.config, state);
+
+        HeaderList displayHeaders;
+        for (const ApiHeader& header : headers) {
+            displayHeaders.emplace_back(header.name, header.value);
+        }
+        char url[MAX_URL_LENGTH];
+        Url displayUrl;
+        if (!ApiRequest::buildUrl(url, sizeof(url), device.config.serverUrls[0], "/api/display") ||
+            !parseUrl(url, displayUrl)) {
+            error = "url";
+        }
+
+        Outcome outcome = Outcome::OK;
+        Connection apiConnection;
+        if (error.empty()) {
+            outcome = httpRequest(apiConnection, "GET", displayUrl, displayHeaders, "", true, ctx_,
+                                  ApiClient::API_TIMEOUT_MS, ApiClient::RESPONSE_BUFFER_SIZE - 1, display);
+            if (outcome != Outcome::OK) {
+                error = std::string("display_") + outcomeName(outcome);
+            } else if (display.status != 200) {
+                error = "display_http_" + std::to_string(display.status);
+            }
+        }
+
+        char imageUrl[MAX_URL_LENGTH] = "";
+        if (error.empty()) {
+            FirmwareUpdate firmware;
+            ApiResult parsed;
+            {
+                // The parser works in a static arena.
+                std::lock_guard<std::mutex> lock(parserMutex_);
+                parsed = ApiResponseParser::parse(display.body.c_str(), display.body.size(), imageUrl, serverRate,
+                                                  status, firmware);
+            }
+            if (parsed.error != ApiError::SUCCESS) {
+                error = "parse";
+            }
+        }
+
+        // Logs queued by earlier failed wakes go up right after /api/display, on the same socket.
+        size_t logsPacked = 0;
+        if (error.empty() && !device.logs.empty()) {
+            Url logUrl;
+            if (ApiRequest::buildUrl(url, sizeof(url), device.config.serverUrls[0], "/api/log") &&
+                parseUrl(url, logUrl)) {
+                const std::string body = logBody(device.logs, device.droppedLogs, logsPacked);
+                const HeaderList logHeaders = {{"ID", device.config.deviceId.c_str()},
+                                               {"Access-Token", device.config.apiKey.c_str()},
+                                               {"Content-Type", "application/json"}};
+                const Outcome logOutcome = httpRequest(apiConnection, "POST", logUrl, logHeaders, body, false, ctx_,
+                                                       ApiClient::API_TIMEOUT_MS, ApiClient::RESPONSE_BUFFER_SIZE - 1,
+                                                       log);
+                if (logOutcome == Outcome::OK && log.status >= 200 && log.status < 300) {
+                    device.logs.erase(device.logs.begin(), device.logs.begin() + static_cast<long>(logsPacked));
+                    device.droppedLogs = 0;
+                } else {
+                    logsPacked = 0;
+                }
+            }
+        }
+        apiConnection.close();
+
+        if (error.empty() && status != TrmnlStatus::NO_UPDATE) {
+            char accept[64];
+            ApiRequest::formatImageAccept(accept, sizeof(accept));
+            Url url;
+            if (!parseUrl(imageUrl, url)) {
+                error = "image_url";
+            } else {
+                Connection imageConnection;
+                outcome = httpRequest(imageConnection, "GET", url, {{"Accept", accept}}, "", false, ctx_,
+                                      ApiClient::IMAGE_TIMEOUT_MS, ApiClient::MAX_IMAGE_SIZE, image);
+                if (outcome != Outcome::OK) {
+                    error = std::string("image_") + outcomeName(outcome);
+                } else if (image.status != 200) {
+                    error = "image_http_" + std::to_string(image.status);
+                }
+            }
+        }
+
+        // Next wake, as runOnce() plans it.
+        double sleepSeconds;
+        if (error.empty()) {
+            device.failedWakes = 0;
+            RefreshPlan plan;
+            {
+                // RefreshPlanner keeps its last plan in (here: process-wide) RTC state.
+                std::lock_guard<std::mutex> lock(plannerMutex_);
+                plan = RefreshPlanner::plan(serverRate, device.volts, simulatedNow(), device.config);
+            }
+            device.refreshRate = plan.seconds;
+            sleepSeconds = plan.seconds;
+        } else {
+            device.failedWakes++;
+            // What runOnce() queues with LogUploader::enqueue() on a failed wake.
+            if (device.logs.size() == LogUploader::QUEUE_SIZE) {
+                device.logs.pop_front();
+                device.droppedLogs++;
+            }
+            const int32_t code = display.status != 200 ? display.status : image.status;
+            device.logs.push_back({device.nextLogId++, static_cast<uint32_t>(simulatedNow()), code,
+                                   error.substr(0, LogUploader::MESSAGE_MAX - 1)});
+            uint32_t backoff = WakeBudget::backoffSeconds(device.failedWakes, device.config);
+            RefreshPlanner::deferPastQuietHours(backoff, simulatedNow(), device.config);
+            sleepSeconds = backoff;
+        }
+        sleepSeconds = sleepSeconds * device.timerScale +
+                       std::uniform_int_distribution<int>(0, options_.jitterMs)(rng) / 1000.0;
+
+        std::lock_guard<std::mutex> lock(stats.mutex);
+        stats.wakes++;
+        stats.lagMs.push_back(lagMs);
+        if (display.status != 0) {
+            stats.displayMs.push_back(display.totalMs);
+            stats.ttfbMs.push_back(display.ttfbMs);
+            stats.connectMs.push_back(display.connectMs);
+        }
+        if (error.empty() && status == TrmnlStatus::NO_UPDATE) {
+            stats.noUpdate++;
+        }
+        if (error.empty() && status != TrmnlStatus::NO_UPDATE) {
+            stats.images++;
+            stats.imageBytes += image.body.size();
+            stats.imageMs.push_back(image.totalMs);
+        }
+        if (log.status != 0) {
+            stats.logMs.push_back(log.totalMs);
+            stats.logsSent += static_cast<uint32_t>(logsPacked);
+            if (logsPacked == 0) {
+                stats.logFailures++;
+            }
+        }
+        if (!error.empty()) {
+            stats.errors[error]++;
+        }
+        if (stats.csv != nullptr) {
+            fprintf(stats.csv, "%.3f,%s,%u,%d,%u,%u,%u,%d,%u,%zu,%.0f,%s\n", elapsedSeconds(),
+                    device.config.deviceId.c_str(), lagMs, display.status, display.connectMs, display.ttfbMs,
+                    display.totalMs, image.status, image.totalMs, image.body.size(), sleepSeconds, error.c_str());
+        }
+        return sleepSeconds;
+    }
+
+    void progress(Stats& stats) {
+        std::lock_guard<std::mutex> lock(stats.mutex);
+        uint32_t errors = 0;
+        for (const auto& error : stats.errors) {
+            errors += error.second;
+        }
+        std::vector<uint32_t> display = stats.displayMs;
+        std::sort(display.begin(), display.end());
+        const double seconds = elapsedSeconds();
+        printf("[%6.0fs] wakes %u (%.1f/s), errors %u, display p50 %u ms p99 %u ms\n", seconds, stats.wakes,
+               stats.wakes / seconds, errors, display.empty() ? 0 : display[display.size() / 2],
+               display.empty() ? 0 : display[display.size() * 99 / 100]);
+        fflush(stdout);
+    }
+
+    const Options& options_;
+    SSL_CTX* ctx_;
+    std::mt19937 rng_;
+    std::vector<Device> devices_;
+    Clock::time_point start_;
+    const time_t epoch0_ = time(nullptr);
+
+    std::mutex queueMutex_;
+    std::condition_variable queueReady_;
+    std::priority_queue<Due, std::vector<Due>, std::greater<Due>> queue_;
+    bool stopping_ = false;
+
+    std::mutex parserMutex_;
+    std::mutex plannerMutex_;
+};
+
+// ---------------------------------------------------------------------------
+// Report
+
+uint32_t percentile(const std::vector<uint32_t>& sorted, const double p) {
+    if (sorted.empty()) {
+        return 0;
+    }
+    const size_t index = static_cast<size_t>(p * static_cast<double>(sorted.size() - 1) + 0.5);
+    return sorted[std::min(index, sorted.size() - 1)];
+}
+
+void printLatency(const char* name, std::vector<uint32_t> samples) {
+    std::sort(samples.begin(), samples.end());
+    printf("  %-16s %8zu %8u %8u %8u %8u\n", name, samples.size(), percentile(samples, 0.50), percentile(samples, 0.90),
+           percentile(samples, 0.99), samples.empty() ? 0 : samples.back());
+}
+
+void printReport(const Options& options, const Stats& stats, const size_t devices, const double seconds) {
+    printf("\n%zu devices, %.0f s real (%.0f s simulated at %gx), %d workers\n", devices, seconds,
+           seconds * options.speed, options.speed, options.workers);
+    printf("wakes      %u (%.2f/s)\n", stats.wakes, stats.wakes / seconds);
+    printf("no update  %u\n", stats.noUpdate);
+    printf("images     %u (%.2f/s, %.1f MB, %.2f MB/s)\n", stats.images, stats.images / seconds,
+           stats.imageBytes / 1e6, stats.imageBytes / 1e6 / seconds);
+    printf("log posts  %zu (%u entries from failed wakes, %u rejected)\n", stats.logMs.size(), stats.logsSent,
+           stats.logFailures);
+
+    printf("\n  %-16s %8s %8s %8s %8s %8s\n", "latency ms", "n", "p50", "p90", "p99", "max");
+    printLatency("display total", stats.displayMs);
+    printLatency("display connect", stats.connectMs);
+    printLatency("display ttfb", stats.ttfbMs);
+    printLatency("image total", stats.imageMs);
+    printLatency("log upload", stats.logMs);
+    printLatency("schedule lag", stats.lagMs);
+
+    if (!stats.errors.empty()) {
+        printf("\nerrors\n");
+        for (const auto& error : stats.errors) {
+            printf("  %-24s %u\n", error.first.c_str(), error.second);
+        }
+    }
+    std::vector<uint32_t> lag = stats.lagMs;
+    std::sort(lag.begin(), lag.end());
+    if (percentile(lag, 0.99) > 1000) {
+        printf("\nnote: wakes started late; raise --workers or the numbers measure the generator, not the server\n");
+    }
+}
+
+bool loadKeys(const std::string& path, std::vector<std::pair<std::string, std::string>>& out) {
+    FILE* f = fopen(path.c_str(), "r");
+    if (f == nullptr) {
+        return false;
+    }
+    char line[256];
+    while (fgets(line, sizeof(line), f) != nullptr) {
+        char id[96];
+        char key[128];
+        if (line[0] != '#' && sscanf(line, " %95[^,\n] , %127[^,\n\r ]", id, key) == 2) {
+            out.emplace_back(id, key);
+        }
+    }
+    fclose(f);
+    return true;
+}
+
+int usage(const char* argv0) {
+    fprintf(stderr,
+            "usage: %s --server URL [--devices N] [--duration S] [--speed X] [--workers W]\n"
+            "          [--interval S] [--align S] [--drift-ppm P] [--jitter-ms MS] [--herd]\n"
+            "          [--api-key KEY | --keys FILE] [--csv FILE] [--report S] [--seed N]\n",
+            argv0);
+    return 2;
+}
+
+}  // namespace
+
+int main(int argc, char** argv) {
+    Options options;
+    for (int i = 1; i < argc; ++i) {
+        const std::string arg = argv[i];
+        const bool hasValue = i + 1 < argc;
+        if (arg == "--herd") {
+            options.herd = true;
+        } else if (!hasValue) {
+            return usage(argv[0]);
+        } else if (arg == "--server") {
+            options.server = argv[++i];
+        } else if (arg == "--devices") {
+            options.devices = std::max(1, atoi(argv[++i]));
+        } else if (arg == "--workers") {
+            options.workers = std::max(1, atoi(argv[++i]));
+        } else if (arg == "--duration") {
+            options.duration = std::max(1.0, atof(argv[++i]));
+        } else if (arg == "--speed") {
+            options.speed = std::max(0.001, atof(argv[++i]));
+        } else if (arg == "--interval") {
+            options.interval = static_cast<uint32_t>(std::max(1, atoi(argv[++i])));
+        } else if (arg == "--align") {
+            options.align = static_cast<uint32_t>(std::max(0, atoi(argv[++i])));
+        } else if (arg == "--drift-ppm") {
+            options.driftPpm = std::max(0, atoi(argv[++i]));
+        } else if (arg == "--jitter-ms") {
+            options.jitterMs = std::max(0, atoi(argv[++i]));
+        } else if (arg == "--api-key") {
+            options.apiKey = argv[++i];
+        } else if (arg == "--keys") {
+            options.keysPath = argv[++i];
+        } else if (arg == "--csv") {
+            options.csvPath = argv[++i];
+        } else if (arg == "--report") {
+            options.report = std::max(1.0, atof(argv[++i]));
+        } else if (arg == "--seed") {
+            options.seed = static_cast<unsigned>(atoi(argv[++i]));
+        } else {
+            return usage(argv[0]);
+        }
+    }
+    Url check;
+    if (!parseUrl(options.server, check)) {
+        fprintf(stderr, "--server must be an http:// or https:// URL\n");
+        return usage(argv[0]);
+    }
+
+    // Like use_insecure_tls: the certificate is not checked.
+    SSL_CTX* ctx = SSL_CTX_new(TLS_client_method());
+    SSL_CTX_set_verify(ctx, SSL_VERIFY_NONE, nullptr);
+#ifdef SSL_OP_IGNORE_UNEXPECTED_EOF
+    SSL_CTX_set_options(ctx, SSL_OP_IGNORE_UNEXPECTED_EOF);
+#endif
+    SSL_CTX_set_session_cache_mode(ctx, SSL_SESS_CACHE_OFF);
+
+    Fleet fleet(options, ctx);
+    if (!options.keysPath.empty()) {
+        std::vector<std::pair<std::string, std::string>> keys;
+        if (!loadKeys(options.keysPath, keys) || keys.empty()) {
+            fprintf(stderr, "no \"id,api_key\" lines in %s\n", options.keysPath.c_str());
+            return 2;
+        }
+        for (int i = 0; i < options.devices && i < static_cast<int>(keys.size()); ++i) {
+            fleet.addDevice(keys[i].first, keys[i].second);
+        }
+    } else {
+        // MAC-style IDs, as a device without device_id reports.
+        for (int i = 0; i < options.devices; ++i) {
+            char id[24];
+            snprintf(id, sizeof(id), "4C:47:%02X:%02X:%02X:%02X", (i >> 24) & 0xFF, (i >> 16) & 0xFF, (i >> 8) & 0xFF,
+                     i & 0xFF);
+            fleet.addDevice(id, options.apiKey);
+        }
+    }
+
+    Stats stats;
+    if (!options.csvPath.empty()) {
+        stats.csv = fopen(options.csvPath.c_str(), "w");
+        if (stats.csv == nullptr) {
+            fprintf(stderr, "cannot write %s\n", options.csvPath.c_str());
+            return 2;
+        }
+        fprintf(stats.csv, "t_s,device,lag_ms,display_status,connect_ms,ttfb_ms,display_ms,image_status,image_ms,"
+                           "image_bytes,next_sleep_s,error\n");
+    }
+
+    printf("%zu devices against %s for %.0f s (speed %gx, %d workers)\n", fleet.size(), options.server.c_str(),
+           options.duration, options.speed, options.workers);
+    fleet.run(stats);
+    printReport(options, stats, fleet.size(), fleet.elapsedSeconds());
+
+    if (stats.csv != nullptr) {
+        fclose(stats.csv);
+    }
+    SSL_CTX_free(ctx);
+    return stats.errors.empty() ? 0 : 1;
+}
@@ -0,0 +1,38 @@
+#!/usr/bin/env bash
+# Fleet load generator: simulated devices against a TRMNL/BYOS server.
+#
+#   tools/loadgen/loadgen.sh --server URL [--devices N] [--duration S] [--speed X] ...
+#
+# Requests, response parsing and wake planning are the firmware's own
+# ApiRequest, ApiResponseParser, RefreshPlanner and WakeBudget, built against
+# the stand-ins in tools/host/. Needs OpenSSL; ArduinoJson comes from
+# $ARDUINOJSON_SRC or the PlatformIO libdeps, as for tools/bench.
+set -euo pipefail
+
+ROOT="$(cd "$(dirname "$0")/../.." && pwd)"
+OUT="$ROOT/.bench"
+CXX="${CXX:-c++}"
+
+AJ="${ARDUINOJSON_SRC:-}"
+if [ -z "$AJ" ]; then
+    AJ="$(ls -d "$ROOT"/.pio/libdeps/*/ArduinoJson/src 2>/dev/null | head -n 1 || true)"
+fi
+if [ -z "$AJ" ] || [ ! -f "$AJ/ArduinoJson.h" ]; then
+    echo "ArduinoJson not found: set ARDUINOJSON_SRC or run 'pio pkg install'" >&2
+    exit 1
+fi
+
+CXXFLAGS=(-std=gnu++17 -O2 -g -Wall -I "$ROOT/tools/host/include" -I "$ROOT/src" -I "$AJ")
+SOURCES=(
+    "$ROOT/src/ApiRequest.cpp"
+    "$ROOT/src/ApiResponseParser.cpp"
+    "$ROOT/src/ArenaAllocator.cpp"
+    "$ROOT/src/RefreshPlanner.cpp"
+    "$ROOT/src/WakeBudget.cpp"
+    "$ROOT/tools/host/host_stubs.cpp"
+    "$ROOT/tools/loadgen/loadgen.cpp"
+)
+
+mkdir -p "$OUT"
+"$CXX" "${CXXFLAGS[@]}" -DNDEBUG "${SOURCES[@]}" -o "$OUT/loadgen" -lssl -lcrypto -lpthread
+"$OUT/loadgen" "$@"
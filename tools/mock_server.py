@@ -0,0 +1,183 @@
+#!/usr/bin/env python3
+"""Local stand-in for a TRMNL/BYOS server.
+
+Serves the endpoints the firmware talks to:
+  GET  /api/display   JSON with image_url, refresh_rate and optional firmware fields
+  GET  /image.bmp     generated 800x480 1-bit checkerboard BMP (honors Range/If-Range),
+                      or the same image as a raw framebuffer with --framebuffer
+  GET  /firmware.bin  the file given with --firmware
+  POST /api/log       device log upload (printed to stdout)
+
+The firmware always uses WiFiClientSecure, so pass --cert/--key to serve HTTPS
+(a self-signed pair is fine with use_insecure_tls: true).
+"""
+
+import argparse
+import hashlib
+import http.server
+import json
+import os
+import re
+import ssl
+import struct
+import sys
+import zlib
+from email.utils import formatdate
+
+# Must match the firmware's Panel (src/PanelGeometry.h, TRMNL_PANEL)
+WIDTH = 800
+HEIGHT = 480
+
+# Must match ImageRenderer::FRAMEBUFFER_* in src/ImageRenderer.h
+FRAMEBUFFER_CONTENT_TYPE = "application/x-trmnl-framebuffer"
+FRAMEBUFFER_VERSION = 1
+
+
+def checkerboard_bmp(cell=40):
+    row_bytes = (WIDTH + 31) // 32 * 4
+    pixels = bytearray()
+    for y in range(HEIGHT - 1, -1, -1):  # bottom-up
+        row = bytearray(row_bytes)
+        for x in range(WIDTH):
+            if ((x // cell) + (y // cell)) % 2:
+                row[x // 8] |= 0x80 >> (x % 8)
+        pixels += row
+    palette = struct.pack("<II", 0x00000000, 0x00FFFFFF)
+    offset = 14 + 40 + len(palette)
+    header = struct.pack("<2sIHHI", b"BM", offset + len(pixels), 0, 0, offset)
+    info = struct.pack("<IiiHHIIiiII", 40, WIDTH, HEIGHT, 1, 1, 0, len(pixels), 2835, 2835, 2, 2)
+    return header + info + palette + bytes(pixels)
+
+
+def checkerboard_framebuffer(cell=40):
+    # Panel layout: top-down rows, MSB first, 1 = white, no padding.
+    row_bytes = WIDTH // 8
+    pixels = bytearray(row_bytes * HEIGHT)
+    for y in range(HEIGHT):
+        for x in range(WIDTH):
+            if ((x // cell) + (y // cell)) % 2:
+                pixels[y * row_bytes + x // 8] |= 0x80 >> (x % 8)
+    header = struct.pack("<4sBBHHHI", b"TRFB", FRAMEBUFFER_VERSION, 0, WIDTH, HEIGHT, 0, zlib.crc32(pixels))
+    return header + bytes(pixels)
+
+
+class Handler(http.server.BaseHTTPRequestHandler):
+    protocol_version = "HTTP/1.1"  # keep-alive, so /api/log can reuse the socket
+
+    def base_url(self):
+        scheme = "https" if self.server.tls else "http"
+        return "%s://%s" % (scheme, self.headers.get("Host", "localhost"))
+
+    def send_body(self, code, body, content_type, headers=None, drop_after=None):
+        self.send_response(code)
+        self.send_header("Date", formatdate(usegmt=True))
+        self.send_header("Content-Type", content_type)
+        self.send_header("Content-Length", str(len(body)))
+        for name, value in (headers or {}).items():
+            self.send_header(name, value)
+        self.end_headers()
+        if drop_after is not None and drop_after < len(body):
+            # Simulate a dropped connection partway through the body.
+            self.wfile.write(body[:drop_after])
+            self.close_connection = True
+            return
+        self.wfile.write(body)
+
+    def send_image(self):
+        image, content_type = self.server.image, "image/bmp"
+        if self.server.framebuffer is not None and FRAMEBUFFER_CONTENT_TYPE in self.headers.get("Accept", ""):
+            image, content_type = self.server.framebuffer, FRAMEBUFFER_CONTENT_TYPE
+        etag = '"%s"' % hashlib.sha256(image).hexdigest()[:16]
+        headers = {"ETag": etag, "Accept-Ranges": "bytes", "Vary": "Accept"}
+        drop_after = self.server.opts.drop_after or None
+
+        m = re.fullmatch(r"bytes=(\d+)-", self.headers.get("Range", ""))
+        if_range = self.headers.get("If-Range")
+        if m and (if_range is None or if_range == etag):
+            start = int(m.group(1))
+            if start >= len(image):
+                self.send_body(416, b"", "text/plain", {"Content-Range": "bytes */%d" % len(image)})
+                return
+            print("image: resuming at %d/%d" % (start, len(image)))
+            headers["Content-Range"] = "bytes %d-%d/%d" % (start, len(image) - 1, len(image))
+            self.send_body(206, image[start:], content_type, headers, drop_after)
+            return
+        self.send_body(200, image, content_type, headers, drop_after)
+
+    def do_GET(self):
+        opts = self.server.opts
+        if self.path == "/api/display":
+            print("display: ID=%s Battery-Voltage=%s RSSI=%s FW-Version=%s" % (
+                self.headers.get("ID"), self.headers.get("Battery-Voltage"),
+                self.headers.get("RSSI"), self.headers.get("FW-Version")))
+            doc = {"status": opts.status, "refresh_rate": opts.refresh_rate}
+            if opts.status == 0:
+                doc["image_url"] = self.base_url() + "/image.bmp"
+                doc["filename"] = "mock"
+            if self.server.firmware is not None:
+                doc["update_firmware"] = True
+                doc["firmware_url"] = self.base_url() + "/firmware.bin"
+                doc["firmware_sha256"] = self.server.firmware_sha256
+            self.send_body(200, json.dumps(doc).encode(), "application/json")
+        elif self.path == "/image.bmp":
+            self.send_image()
+        elif self.path == "/firmware.bin" and self.server.firmware is not None:
+            self.send_body(200, self.server.firmware, "application/octet-stream")
+        else:
+            self.send_body(404, b"not found", "text/plain")
+
+    def do_POST(self):
+        length = int(self.headers.get("Content-Length", "0"))
+        body = self.rfile.read(length)
+        if self.path == "/api/log":
+            print("log: %s" % body.decode(errors="replace"))
+            self.send_body(200, b"{}", "application/json")
+        else:
+            self.send_body(404, b"not found", "text/plain")
+
+
+def main():
+    parser = argparse.ArgumentParser(description=__doc__, formatter_class=argparse.RawDescriptionHelpFormatter)
+    parser.add_argument("--host", default="0.0.0.0")
+    parser.add_argument("--port", type=int, default=8443)
+    parser.add_argument("--cert", help="TLS certificate (PEM)")
+    parser.add_argument("--key", help="TLS private key (PEM)")
+    parser.add_argument("--status", type=int, default=0, help="TRMNL status to return (0 = new image, 202 = no update)")
+    parser.add_argument("--refresh-rate", type=int, default=300)
+    parser.add_argument("--drop-after", type=int, default=0,
+                        help="close the connection after this many image bytes per response (tests resume)")
+    parser.add_argument("--framebuffer", action="store_true",
+                        help="serve the raw framebuffer format to clients that accept it")
+    parser.add_argument("--firmware", help="offer this firmware.bin as an update")
+    parser.add_argument("--bad-sha", action="store_true", help="advertise a wrong SHA-256 (tests rejection)")
+    opts = parser.parse_args()
+
+    server = http.server.ThreadingHTTPServer((opts.host, opts.port), Handler)
+    server.opts = opts
+    server.image = checkerboard_bmp()
+    server.framebuffer = checkerboard_framebuffer() if opts.framebuffer else None
+    server.firmware = None
+    server.firmware_sha256 = None
+    if opts.firmware:
+        with open(opts.firmware, "rb") as f:
+            server.firmware = f.read()
+        digest = hashlib.sha256(server.firmware).hexdigest()
+        server.firmware_sha256 = ("0" * 64) if opts.bad_sha else digest
+        print("offering %s (%d bytes, sha256 %s)" % (os.path.basename(opts.firmware), len(server.firmware), digest))
+
+    server.tls = bool(opts.cert)
+    if server.tls:
+        ctx = ssl.SSLContext(ssl.PROTOCOL_TLS_SERVER)
+        ctx.load_cert_chain(opts.cert, opts.key)
+        server.socket = ctx.wrap_socket(server.socket, server_side=True)
+
+    print("listening on %s://%s:%d" % ("https" if server.tls else "http", opts.host, opts.port))
+    try:
+        server.serve_forever()
+    except KeyboardInterrupt:
+        pass
+    return 0
+
+
+if __name__ == "__main__":
+    sys.exit(main())
@@ -0,0 +1,258 @@
+// Host framebuffer simulator: draws each screen the firmware can show into
+// the host EInkDisplay, checks its CRC-32 against tools/sim/golden.txt and
+// times it. Build and run with tools/sim/sim.sh.
+//
+//   sim [--golden FILE] [--update] [--dump DIR] [--repeat N]
+//
+// Exit status is 1 if any frame differs from its golden hash.
+
+#include <esp_rom_crc.h>
+
+#include <algorithm>
+#include <chrono>
+#include <functional>
+#include <map>
+#include <string>
+#include <vector>
+
+#include "ErrorDisplay.h"
+#include "ImageRenderer.h"
+#include "PanelGeometry.h"
+#include "TextDraw.h"
+#include "inputs.h"
+
+namespace {
+
+struct Scene {
+    const char* name;
+    std::function<bool(EInkDisplay&)> draw;  ///< false if the firmware code reported an error
+};
+
+// Inputs are built once, outside the timed region.
+const std::vector<uint8_t>& bmp(const BenchInputs::BmpPattern pattern) {
+    static const std::vector<uint8_t> images[] = {
+        BenchInputs::makeBmp(BenchInputs::BmpPattern::ALL_WHITE),
+        BenchInputs::makeBmp(BenchInputs::BmpPattern::DENSE),
+        BenchInputs::makeBmp(BenchInputs::BmpPattern::INVERTED_PALETTE),
+    };
+    return images[static_cast<int>(pattern)];
+}
+
+const std::vector<uint8_t>& rawFramebuffer() {
+    static const std::vector<uint8_t> fb = BenchInputs::makeFramebuffer();
+    return fb;
+}
+
+bool renderImage(EInkDisplay& display, const std::vector<uint8_t>& image) {
+    return ImageRenderer::render(image.data(), image.size(), display) == ImageRenderer::BmpResult::SUCCESS;
+}
+
+// The wake path: decode() hashes rows as it writes them, and that hash must
+// match one taken over the finished frame.
+bool decodeHashed(EInkDisplay& display, const std::vector<uint8_t>& image) {
+    uint32_t hash = 0;
+    return ImageRenderer::decode(image.data(), image.size(), display, &hash) == ImageRenderer::BmpResult::SUCCESS &&
+           hash == ImageRenderer::frameHash(display.getFrameBuffer());
+}
+
+bool drawAllGlyphs(EInkDisplay& display) {
+    display.clearScreen(0xFF);
+    char line[17] = {0};
+    int16_t y = 8;
+    for (int c = 32; c < 127; c += 16, y += 24) {
+        for (int i = 0; i < 16; ++i) {
+            line[i] = static_cast<char>(c + i < 127 ? c + i : ' ');
+        }
+        TextDraw::drawString(display, line, 8, y);
+    }
+    return true;
+}
+
+// Glyphs straddling every panel edge exercise the clipping paths.
+bool drawClippedGlyphs(EInkDisplay& display) {
+    display.clearScreen(0xFF);
+    const int16_t right = static_cast<int16_t>(Panel::WIDTH - 4);
+    const int16_t bottom = static_cast<int16_t>(Panel::HEIGHT - 6);
+    TextDraw::drawChar(display, 'W', -4, 100);
+    TextDraw::drawChar(display, 'W', right, 100);
+    TextDraw::drawChar(display, 'W', 100, -6);
+    TextDraw::drawChar(display, 'W', 100, bottom);
+    TextDraw::drawChar(display, 'W', -4, -6);
+    TextDraw::drawChar(display, 'W', right, bottom);
+    TextDraw::drawCenteredString(display, "CONFIRM: START", 200);
+    return true;
+}
+
+const std::vector<Scene>& scenes() {
+    static const std::vector<Scene> all = {
+        {"bmp_all_white", [](EInkDisplay& d) { return renderImage(d, bmp(BenchInputs::BmpPattern::ALL_WHITE)); }},
+        {"bmp_dense", [](EInkDisplay& d) { return renderImage(d, bmp(BenchInputs::BmpPattern::DENSE)); }},
+        {"bmp_inverted_palette",
+         [](EInkDisplay& d) { return renderImage(d, bmp(BenchInputs::BmpPattern::INVERTED_PALETTE)); }},
+        {"bmp_dense_hashed", [](EInkDisplay& d) { return decodeHashed(d, bmp(BenchInputs::BmpPattern::DENSE)); }},
+        {"framebuffer_raw", [](EInkDisplay& d) { return renderImage(d, rawFramebuffer()); }},
+        {"text_glyphs", drawAllGlyphs},
+        {"text_clipped", drawClippedGlyphs},
+        {"error_no_sd",
+         [](EInkDisplay& d) {
+             ErrorDisplay::showNoSdCard(d);
+             return true;
+         }},
+        {"error_no_config",
+         [](EInkDisplay& d) {
+             ErrorDisplay::showNoConfig(d);
+             return true;
+         }},
+        {"error_wifi",
+         [](EInkDisplay& d) {
+             ErrorDisplay::showWiFiError(d, "HomeNetwork-5G");
+             return true;
+         }},
+        {"error_api_500",
+         [](EInkDisplay& d) {
+             ErrorDisplay::showApiError(d, 500);
+             return true;
+         }},
+        {"error_generic",
+         [](EInkDisplay& d) {
+             ErrorDisplay::showGenericError(d, "Image Render Failed");
+             return true;
+         }},
+    };
+    return all;
+}
+
+uint32_t frameCrc(EInkDisplay& display) {
+    return esp_rom_crc32_le(0, display.getFrameBuffer(), Panel::BUFFER_SIZE);
+}
+
+// Binary PBM (P4): rows MSB first, 1 = black.
+bool writePbm(const std::string& path, EInkDisplay& display) {
+    FILE* f = fopen(path.c_str(), "wb");
+    if (f == nullptr) {
+        return false;
+    }
+    fprintf(f, "P4\n%u %u\n", static_cast<unsigned>(Panel::WIDTH), static_cast<unsigned>(Panel::HEIGHT));
+    const uint8_t* fb = display.getFrameBuffer();
+    std::vector<uint8_t> row(Panel::WIDTH_BYTES);
+    for (uint32_t y = 0; y < Panel::HEIGHT; ++y) {
+        const uint8_t* src = fb + y * Panel::WIDTH_BYTES;
+        std::fill(row.begin(), row.end(), 0);
+        for (uint16_t x = 0; x < Panel::WIDTH; ++x) {
+            const bool set = (src[x / 8] & Panel::mask(x)) != 0;
+            if (set == (Panel::BLACK_BYTE != 0)) {
+                row[x / 8] |= static_cast<uint8_t>(0x80u >> (x & 7u));
+            }
+        }
+        fwrite(row.data(), 1, row.size(), f);
+    }
+    return fclose(f) == 0;
+}
+
+std::map<std::string, uint32_t> readGolden(const std::string& path) {
+    std::map<std::string, uint32_t> golden;
+    FILE* f = fopen(path.c_str(), "r");
+    if (f == nullptr) {
+        return golden;
+    }
+    char line[128];
+    while (fgets(line, sizeof(line), f) != nullptr) {
+        char name[64];
+        unsigned crc = 0;
+        if (line[0] != '#' && sscanf(line, "%63s %x", name, &crc) == 2) {
+            golden[name] = crc;
+        }
+    }
+    fclose(f);
+    return golden;
+}
+
+bool writeGolden(const std::string& path, const std::vector<std::pair<std::string, uint32_t>>& frames) {
+    FILE* f = fopen(path.c_str(), "w");
+    if (f == nullptr) {
+        return false;
+    }
+    fprintf(f, "# CRC-32 of each simulator frame (%ux%u). Regenerate with: tools/sim/sim.sh update\n",
+            static_cast<unsigned>(Panel::WIDTH), static_cast<unsigned>(Panel::HEIGHT));
+    for (const auto& frame : frames) {
+        fprintf(f, "%s %08x\n", frame.first.c_str(), frame.second);
+    }
+    return fclose(f) == 0;
+}
+
+double medianUs(std::vector<double> samples) {
+    std::sort(samples.begin(), samples.end());
+    return samples[samples.size() / 2];
+}
+
+}  // namespace
+
+int main(int argc, char** argv) {
+    std::string goldenPath = "tools/sim/golden.txt";
+    std::string dumpDir;
+    bool update = false;
+    int repeat = 20;
+    for (int i = 1; i < argc; ++i) {
+        const std::string arg = argv[i];
+        if (arg == "--golden" && i + 1 < argc) {
+            goldenPath = argv[++i];
+        } else if (arg == "--dump" && i + 1 < argc) {
+            dumpDir = argv[++i];
+        } else if (arg == "--repeat" && i + 1 < argc) {
+            repeat = std::max(1, atoi(argv[++i]));
+        } else if (arg == "--update") {
+            update = true;
+        } else {
+            fprintf(stderr, "usage: %s [--golden FILE] [--update] [--dump DIR] [--repeat N]\n", argv[0]);
+            return 2;
+        }
+    }
+
+    const std::map<std::string, uint32_t> golden = readGolden(goldenPath);
+    std::vector<std::pair<std::string, uint32_t>> frames;
+    EInkDisplay display;
+    int failures = 0;
+
+    printf("%-22s %-8s %-8s %10s %10s\n", "scene", "crc32", "golden", "median_us", "min_us");
+    for (const Scene& scene : scenes()) {
+        std::vector<double> samples;
+        bool ok = true;
+        for (int r = 0; r < repeat; ++r) {
+            // Start every run from a non-white screen so a scene that forgets
+            // to clear shows up as a diff.
+            display.clearScreen(0x00);
+            const auto start = std::chrono::steady_clock::now();
+            ok = scene.draw(display) && ok;
+            const auto end = std::chrono::steady_clock::now();
+            samples.push_back(std::chrono::duration<double, std::micro>(end - start).count());
+        }
+
+        const uint32_t crc = frameCrc(display);
+        frames.emplace_back(scene.name, crc);
+        const auto expected = golden.find(scene.name);
+        const char* verdict = "new";
+        if (!ok) {
+            verdict = "ERROR";
+            failures++;
+        } else if (expected != golden.end()) {
+            verdict = expected->second == crc ? "ok" : "DIFF";
+            failures += (expected->second == crc || update) ? 0 : 1;
+        }
+        printf("%-22s %08x %-8s %10.1f %10.1f\n", scene.name, crc, verdict, medianUs(samples),
+               *std::min_element(samples.begin(), samples.end()));
+
+        if (!dumpDir.empty() && !writePbm(dumpDir + "/" + scene.name + ".pbm", display)) {
+            fprintf(stderr, "cannot write %s/%s.pbm\n", dumpDir.c_str(), scene.name);
+            return 2;
+        }
+    }
+
+    if (update) {
+        if (!writeGolden(goldenPath, frames)) {
+            fprintf(stderr, "cannot write %s\n", goldenPath.c_str());
+            return 2;
+        }
+        printf("golden: %s\n", goldenPath.c_str());
+    }
+    return failures == 0 ? 0 : 1;
+}
@@ -0,0 +1,50 @@
+#!/usr/bin/env bash
+# Host framebuffer simulator for ImageRenderer, TextDraw and ErrorDisplay.
+#
+#   tools/sim/sim.sh run [--dump DIR] [--repeat N]   build, compare with golden.txt, time each frame
+#   tools/sim/sim.sh update                          build and rewrite golden.txt
+#
+# The firmware sources are built unchanged against the stand-ins in
+# tools/host/. ArduinoJson (headers only, pulled in by ConfigLoader.h) comes
+# from $ARDUINOJSON_SRC or the PlatformIO libdeps, as for tools/bench.
+set -euo pipefail
+
+ROOT="$(cd "$(dirname "$0")/../.." && pwd)"
+OUT="$ROOT/.bench"
+CXX="${CXX:-c++}"
+
+AJ="${ARDUINOJSON_SRC:-}"
+if [ -z "$AJ" ]; then
+    AJ="$(ls -d "$ROOT"/.pio/libdeps/*/ArduinoJson/src 2>/dev/null | head -n 1 || true)"
+fi
+if [ -z "$AJ" ] || [ ! -f "$AJ/ArduinoJson.h" ]; then
+    echo "ArduinoJson not found: set ARDUINOJSON_SRC or run 'pio pkg install'" >&2
+    exit 1
+fi
+
+CXXFLAGS=(-std=gnu++17 -O2 -g -Wall -I "$ROOT/tools/host/include" -I "$ROOT/src" -I "$AJ" -I "$ROOT/tools/bench")
+SOURCES=(
+    "$ROOT/src/ImageRenderer.cpp"
+    "$ROOT/src/TextDraw.cpp"
+    "$ROOT/src/ErrorDisplay.cpp"
+    "$ROOT/tools/host/host_stubs.cpp"
+    "$ROOT/tools/sim/sim.cpp"
+)
+
+mode="${1:-run}"
+shift || true
+mkdir -p "$OUT"
+"$CXX" "${CXXFLAGS[@]}" -DNDEBUG "${SOURCES[@]}" -o "$OUT/sim"
+
+case "$mode" in
+run)
+    "$OUT/sim" --golden "$ROOT/tools/sim/golden.txt" "$@"
+    ;;
+update)
+    "$OUT/sim" --golden "$ROOT/tools/sim/golden.txt" --update "$@"
+    ;;
+*)
+    echo "usage: sim.sh run|update ..." >&2
+    exit 2
+    ;;
+esac
@@ -0,0 +1,117 @@
+#!/usr/bin/env python3
+"""Convert the binary telemetry log written by Telemetry::flush() to CSV.
+
+Pass segment files, or the log directory copied from the SD card
+(/.trmnl/log). In a directory, segments are read oldest first:
+events.3.bin, events.2.bin, events.1.bin, events.bin.
+"""
+
+import argparse
+import csv
+import datetime
+import os
+import re
+import struct
+import sys
+
+FILE_MAGIC = 0x474F4C54
+FILE_VERSION = 1
+
+HEADER = struct.Struct("<IHH8s")
+RECORD = struct.Struct("<IIHHiii")
+
+# Must match Telemetry::Event in src/Telemetry.h: (name, arg names)
+HEAP_EVENT = 14
+FRAME_UNCHANGED_EVENT = 18
+HEAP_STAGES = ("boot", "config", "wifi", "api_response", "image_download", "render")
+
+EVENTS = {
+    1: ("BOOT", ("wake_cause", "reset_reason", "battery_mv")),
+    2: ("CONFIG", ("config_error", "from_snapshot", "")),
+    3: ("WIFI_CONNECTED", ("assoc_ms", "rssi_dbm", "attempts")),
+    4: ("WIFI_FAILED", ("wl_status", "attempts", "")),
+    5: ("API_RESPONSE", ("http_status", "request_ms", "body_bytes")),
+    6: ("API_ERROR", ("api_error", "http_status", "")),
+    7: ("IMAGE_DOWNLOAD", ("http_status", "download_ms", "bytes")),
+    8: ("IMAGE_RENDER", ("bmp_result", "decode_ms", "refresh_ms")),
+    9: ("SLEEP", ("sleep_s", "battery_factor_x100", "quiet_hours")),
+    10: ("RECORDS_DROPPED", ("count", "", "")),
+    11: ("OTA", ("ota_result", "bytes", "ms")),
+    12: ("SERVER_FAILOVER", ("server_index", "http_status", "ms")),
+    13: ("DNS_CACHE", ("hits", "lookups", "ms_saved")),
+    14: ("HEAP", ("stage:min_free", "free", "largest_block")),
+    15: ("DOWNLOAD_STATS", ("bytes_per_s", "reads", "waits")),
+    16: ("CLOCK_SYNC", ("error_ms", "drift_ppm", "since_sync_s")),
+    17: ("WAKE_BUDGET", ("budget_ms", "failed_wakes", "backoff_s")),
+    18: ("FRAME_UNCHANGED", ("frame_hash", "skipped_in_row", "skipped_total")),
+}
+
+
+def segment_files(paths):
+    files = []
+    for path in paths:
+        if not os.path.isdir(path):
+            files.append(path)
+            continue
+        found = []
+        for name in os.listdir(path):
+            m = re.fullmatch(r"events(?:\.(\d+))?\.bin", name)
+            if m:
+                found.append((int(m.group(1) or 0), os.path.join(path, name)))
+        files.extend(p for _, p in sorted(found, reverse=True))
+    return files
+
+
+def read_segment(path):
+    with open(path, "rb") as f:
+        data = f.read()
+    if len(data) < HEADER.size:
+        raise ValueError("%s: too short for a segment header" % path)
+    magic, version, record_size, _ = HEADER.unpack_from(data, 0)
+    if magic != FILE_MAGIC:
+        raise ValueError("%s: bad magic 0x%08x" % (path, magic))
+    if version != FILE_VERSION or record_size != RECORD.size:
+        raise ValueError("%s: unsupported version %d / record size %d" % (path, version, record_size))
+
+    offset = HEADER.size
+    while offset + RECORD.size <= len(data):
+        yield RECORD.unpack_from(data, offset)
+        offset += RECORD.size
+    if offset != len(data):
+        print("WARNING: %s: %d trailing bytes ignored" % (path, len(data) - offset), file=sys.stderr)
+
+
+def main():
+    parser = argparse.ArgumentParser(description=__doc__, formatter_class=argparse.RawDescriptionHelpFormatter)
+    parser.add_argument("paths", nargs="+", help="segment files or log directory")
+    parser.add_argument("-o", "--output", help="CSV output file (default: stdout)")
+    args = parser.parse_args()
+
+    out = open(args.output, "w", newline="") if args.output else sys.stdout
+    writer = csv.writer(out)
+    writer.writerow(["utc", "epoch", "uptime_ms", "wake", "event", "a0", "a1", "a2", "arg_names"])
+
+    try:
+        for path in segment_files(args.paths):
+            for epoch, uptime_ms, event, wake, a0, a1, a2 in read_segment(path):
+                name, arg_names = EVENTS.get(event, ("EVENT_%d" % event, ("", "", "")))
+                if event == HEAP_EVENT:
+                    # a0 packs the stage (low byte) with the all-time minimum free heap.
+                    stage = a0 & 0xFF
+                    a0 = "%s:%d" % (HEAP_STAGES[stage] if stage < len(HEAP_STAGES) else stage, a0 >> 8)
+                elif event == FRAME_UNCHANGED_EVENT:
+                    a0 = "%08x" % (a0 & 0xFFFFFFFF)
+                utc = (datetime.datetime.fromtimestamp(epoch, datetime.timezone.utc).strftime("%Y-%m-%dT%H:%M:%SZ")
+                       if epoch else "")
+                writer.writerow([utc, epoch, uptime_ms, wake, name, a0, a1, a2, "/".join(n for n in arg_names if n)])
+    except ValueError as e:
+        print("ERROR: %s" % e, file=sys.stderr)
+        return 1
+    finally:
+        if out is not sys.stdout:
+            out.close()
+    return 0
+
+
+if __name__ == "__main__":
+    sys.exit(main())